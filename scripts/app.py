@@ -10,12 +10,66 @@ import requests
 from pathlib import Path
 from datetime import datetime, timedelta
 import json
+import os
+import threading
+import time
 
 app = Flask(__name__)
 
 OUTPUT_DIR = Path(__file__).parent.parent / "output"
 
+# How long fetched data is served before Yahoo is asked again (seconds)
+QUOTE_TTL = float(os.environ.get('STOCKSENSE_QUOTE_TTL', '15'))
+HISTORY_TTL = float(os.environ.get('STOCKSENSE_HISTORY_TTL', '60'))
+
+class TTLCache:
+    """Per-key TTL cache that also coalesces concurrent misses.
+
+    While one request is fetching a key, other requests for the same key
+    wait for that result instead of issuing their own upstream call, so
+    Yahoo traffic scales with distinct keys per TTL window rather than with
+    the number of viewers polling the page.
+    """
+
+    def __init__(self, ttl):
+        self.ttl = ttl
+        self.lock = threading.Lock()
+        self.entries = {}   # key -> (expires_at, value)
+        self.pending = {}   # key -> threading.Event for the fetch in flight
+
+    def get(self, key, fetch):
+        while True:
+            with self.lock:
+                entry = self.entries.get(key)
+                if entry and entry[0] > time.monotonic():
+                    return entry[1]
+                waiter = self.pending.get(key)
+                if waiter is None:
+                    waiter = self.pending[key] = threading.Event()
+                    break
+            # Someone else is fetching this key; use their result
+            waiter.wait()
+
+        value = None
+        try:
+            value = fetch()
+        finally:
+            with self.lock:
+                # Failures are remembered too, so a bad symbol is not
+                # retried by every poll
+                self.entries[key] = (time.monotonic() + self.ttl, value)
+                del self.pending[key]
+            waiter.set()
+        return value
+
+quote_cache = TTLCache(QUOTE_TTL)
+history_cache = TTLCache(HISTORY_TTL)
+
 def get_live_quote(ticker):
+    """Live quote for a ticker, served from the TTL cache when fresh."""
+    return quote_cache.get(ticker, lambda: fetch_live_quote(ticker))
+
+def fetch_live_quote(ticker):
     """Fetch live stock quote from Yahoo Finance API."""
     try:
         # Use 5-day range to get more complete data
@@ -99,6 +153,10 @@ def get_live_quote(ticker):
     return None
 
 def get_historical_data(ticker, period='1mo'):
+    """Chart data for a ticker, served from the TTL cache when fresh."""
+    return history_cache.get((ticker, period), lambda: fetch_historical_data(ticker, period)) or []
+
+def fetch_historical_data(ticker, period='1mo'):
     """Fetch historical stock data for charting."""
     try:
         # Map period to Yahoo Finance range
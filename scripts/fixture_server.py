@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""
+Serves a directory of recorded StockSense HTTP fixtures over real HTTP, so
+the live fetch paths (curl, connection reuse, the multi engine) can be
+benchmarked without touching Yahoo.
+
+Record fixtures first by running StockSense with "http_mode": "record",
+then:
+    python3 scripts/fixture_server.py fixtures --port 8090 --latency-ms 80
+and point "base_url" at http://127.0.0.1:8090 with "http_mode": "live".
+
+Fixture files are named by the 64-bit FNV-1a hash of the request path and
+query, matching HttpFixtures in src/HttpFixtures.cpp.
+"""
+
+import argparse
+import os
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+MAGIC = b"STOCKSENSE-FIXTURE 1"
+
+
+def fnv1a64(key):
+    value = 14695981039346656037
+    for byte in key.encode("utf-8"):
+        value ^= byte
+        value = (value * 1099511628211) & 0xFFFFFFFFFFFFFFFF
+    return value
+
+
+def load_fixture(directory, key):
+    """Returns (status, body) for a request path, or None if not recorded."""
+    path = os.path.join(directory, "%016x.fixture" % fnv1a64(key))
+    try:
+        with open(path, "rb") as f:
+            if f.readline().rstrip(b"\n") != MAGIC:
+                return None
+            headers = {}
+            for line in iter(f.readline, b"\n"):
+                if not line:
+                    return None
+                name, _, value = line.rstrip(b"\n").decode("utf-8").partition(": ")
+                headers[name] = value
+            if headers.get("url") != key:
+                return None
+            body = f.read(int(headers.get("length", "0")))
+            return int(headers.get("status", "200")), body
+    except (OSError, ValueError):
+        return None
+
+
+def make_handler(directory, latency, bandwidth):
+    class FixtureHandler(BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"  # keep-alive, like the real API
+
+        def do_GET(self):
+            time.sleep(latency)
+            fixture = load_fixture(directory, self.path)
+            status, body = fixture if fixture else (404, b"No fixture recorded\n")
+
+            self.send_response(status)
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+
+            chunk = 16384
+            for offset in range(0, len(body), chunk):
+                piece = body[offset:offset + chunk]
+                if bandwidth:
+                    time.sleep(len(piece) / bandwidth)
+                self.wfile.write(piece)
+
+        def log_message(self, format, *args):
+            pass
+
+    return FixtureHandler
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("directory", help="fixture directory written in record mode")
+    parser.add_argument("--port", type=int, default=8090)
+    parser.add_argument("--latency-ms", type=float, default=0,
+                        help="delay before each response")
+    parser.add_argument("--bandwidth-kbps", type=float, default=0,
+                        help="per-response throughput in KiB/s (0 = unlimited)")
+    args = parser.parse_args()
+
+    handler = make_handler(args.directory, args.latency_ms / 1000.0,
+                           args.bandwidth_kbps * 1024)
+    server = ThreadingHTTPServer(("127.0.0.1", args.port), handler)
+    print("Serving fixtures from %s on http://127.0.0.1:%d" % (args.directory, args.port))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,334 @@
+#include "ChartDecoder.h"
+#include "DateUtil.h"
+#include "JsonReader.h"
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Tracks where in the chart document the reader is, so each scalar can be
+// routed without keeping the path as strings
+class ChartHandler : public JsonHandler {
+public:
+    explicit ChartHandler(ChartDocument& output) : document(output) {}
+
+    void StartObject() override { Open(true); }
+    void StartArray() override { Open(false); }
+    void EndObject() override { Close(); }
+    void EndArray() override { Close(); }
+
+    void Key(std::string_view key) override {
+        currentKey = Lookup(key);
+    }
+
+    void String(std::string_view value) override {
+        Frame frame = Top().frame;
+        if (frame == MetaFrame && currentKey == SymbolKey) {
+            document.meta.symbol.assign(value.data(), value.size());
+        } else if (frame == ErrorFrame && currentKey == DescriptionKey) {
+            document.error.assign(value.data(), value.size());
+        }
+    }
+
+    void Number(double value) override {
+        const State& top = Top();
+        if (top.frame == QuoteColumnFrame) {
+            columns[top.column].push_back(value);
+        } else if (top.frame == TimestampFrame) {
+            timestamps.push_back(static_cast<int64_t>(value));
+        } else if (top.frame == MetaFrame) {
+            SetMeta(value);
+        }
+    }
+
+    void Null() override {
+        // Missing bars show up as nulls in every quote column
+        if (Top().frame == QuoteColumnFrame) {
+            columns[Top().column].push_back(NAN);
+        }
+    }
+
+    bool SawResult() const { return sawResult; }
+
+    // Joins timestamps with the quote columns, dropping incomplete rows
+    void BuildBars() {
+        PriceSeries& bars = document.bars;
+        size_t count = timestamps.size();
+        for (const auto& column : columns) {
+            count = std::min(count, column.size());
+        }
+        bars.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            StockData row;
+            row.date = DateUtil::UnixSecondsToDays(timestamps[i] + document.meta.gmtOffset);
+            row.open = columns[OpenColumn][i];
+            row.high = columns[HighColumn][i];
+            row.low = columns[LowColumn][i];
+            row.close = columns[CloseColumn][i];
+            row.volume = columns[VolumeColumn][i];
+            if (std::isnan(row.open) || std::isnan(row.high) || std::isnan(row.low) ||
+                std::isnan(row.close) || std::isnan(row.volume)) {
+                continue;
+            }
+            bars.push_back(row);
+        }
+    }
+
+private:
+    enum Frame {
+        OtherFrame, RootFrame, ChartFrame, ResultArrayFrame, ResultFrame, MetaFrame,
+        TimestampFrame, IndicatorsFrame, QuoteArrayFrame, QuoteFrame, QuoteColumnFrame,
+        ErrorFrame
+    };
+    enum KeyId {
+        OtherKey, ChartKey, ResultKey, ErrorKey, DescriptionKey, MetaKey, TimestampKey,
+        IndicatorsKey, QuoteKey, OpenKey, HighKey, LowKey, CloseKey, VolumeKey, SymbolKey,
+        MarketPriceKey, PreviousCloseKey, ChartPreviousCloseKey, DayHighKey, DayLowKey,
+        DayVolumeKey, MarketTimeKey, GmtOffsetKey
+    };
+    enum Column { OpenColumn, HighColumn, LowColumn, CloseColumn, VolumeColumn, ColumnCount };
+
+    struct State {
+        Frame frame;
+        int column;    // QuoteColumnFrame only
+        int children;  // containers opened directly inside this one
+    };
+
+    static KeyId Lookup(std::string_view key) {
+        static const struct { const char* name; KeyId id; } keys[] = {
+            {"chart", ChartKey}, {"result", ResultKey}, {"error", ErrorKey},
+            {"description", DescriptionKey}, {"meta", MetaKey}, {"timestamp", TimestampKey},
+            {"indicators", IndicatorsKey}, {"quote", QuoteKey}, {"open", OpenKey},
+            {"high", HighKey}, {"low", LowKey}, {"close", CloseKey}, {"volume", VolumeKey},
+            {"symbol", SymbolKey}, {"regularMarketPrice", MarketPriceKey},
+            {"previousClose", PreviousCloseKey}, {"chartPreviousClose", ChartPreviousCloseKey},
+            {"regularMarketDayHigh", DayHighKey}, {"regularMarketDayLow", DayLowKey},
+            {"regularMarketVolume", DayVolumeKey}, {"regularMarketTime", MarketTimeKey},
+            {"gmtoffset", GmtOffsetKey},
+        };
+        for (const auto& entry : keys) {
+            if (key == entry.name) {
+                return entry.id;
+            }
+        }
+        return OtherKey;
+    }
+
+    const State& Top() const {
+        static const State outside = {OtherFrame, 0, 0};
+        return stack.empty() ? outside : stack.back();
+    }
+
+    void Open(bool isObject) {
+        State next = {OtherFrame, 0, 0};
+        if (stack.empty()) {
+            next.frame = isObject ? RootFrame : OtherFrame;
+        } else {
+            State& parent = stack.back();
+            bool first = parent.children++ == 0;
+            switch (parent.frame) {
+                case RootFrame:
+                    if (isObject && currentKey == ChartKey) next.frame = ChartFrame;
+                    break;
+                case ChartFrame:
+                    if (!isObject && currentKey == ResultKey) next.frame = ResultArrayFrame;
+                    if (isObject && currentKey == ErrorKey) next.frame = ErrorFrame;
+                    break;
+                case ResultArrayFrame:
+                    if (isObject && first) {
+                        next.frame = ResultFrame;
+                        sawResult = true;
+                    }
+                    break;
+                case ResultFrame:
+                    if (isObject && currentKey == MetaKey) next.frame = MetaFrame;
+                    if (!isObject && currentKey == TimestampKey) next.frame = TimestampFrame;
+                    if (isObject && currentKey == IndicatorsKey) next.frame = IndicatorsFrame;
+                    break;
+                case IndicatorsFrame:
+                    if (!isObject && currentKey == QuoteKey) next.frame = QuoteArrayFrame;
+                    break;
+                case QuoteArrayFrame:
+                    if (isObject && first) next.frame = QuoteFrame;
+                    break;
+                case QuoteFrame:
+                    if (!isObject && currentKey >= OpenKey && currentKey <= VolumeKey) {
+                        next.frame = QuoteColumnFrame;
+                        next.column = currentKey - OpenKey;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        stack.push_back(next);
+        currentKey = OtherKey;
+    }
+
+    void Close() {
+        if (!stack.empty()) {
+            stack.pop_back();
+        }
+        currentKey = OtherKey;
+    }
+
+    void SetMeta(double value) {
+        ChartMeta& meta = document.meta;
+        switch (currentKey) {
+            case MarketPriceKey:        meta.regularMarketPrice = value; break;
+            case PreviousCloseKey:      meta.previousClose = value; break;
+            case ChartPreviousCloseKey: meta.chartPreviousClose = value; break;
+            case DayHighKey:            meta.regularMarketDayHigh = value; break;
+            case DayLowKey:             meta.regularMarketDayLow = value; break;
+            case DayVolumeKey:          meta.regularMarketVolume = value; break;
+            case MarketTimeKey:         meta.regularMarketTime = static_cast<int64_t>(value); break;
+            case GmtOffsetKey:          meta.gmtOffset = static_cast<int64_t>(value); break;
+            default: break;
+        }
+    }
+
+    ChartDocument& document;
+    std::vector<State> stack;
+    KeyId currentKey = OtherKey;
+    bool sawResult = false;
+    std::vector<int64_t> timestamps;
+    std::vector<double> columns[ColumnCount];
+};
+
+// Collects quoteResponse.result[*] entries of a v7 quote response
+class QuoteListHandler : public JsonHandler {
+public:
+    QuoteListHandler(std::vector<ChartMeta>& output, std::string& errorOutput)
+        : quotes(output), error(errorOutput) {}
+
+    void StartObject() override { Open(true); }
+    void StartArray() override { Open(false); }
+    void EndObject() override { Close(); }
+    void EndArray() override { Close(); }
+
+    void Key(std::string_view key) override {
+        currentKey.assign(key.data(), key.size());
+    }
+
+    void String(std::string_view value) override {
+        if (Top() == EntryFrame && currentKey == "symbol") {
+            quotes.back().symbol.assign(value.data(), value.size());
+        } else if (Top() == ErrorFrame && currentKey == "description") {
+            error.assign(value.data(), value.size());
+        }
+    }
+
+    void Number(double value) override {
+        if (Top() != EntryFrame) {
+            return;
+        }
+        ChartMeta& quote = quotes.back();
+        if (currentKey == "regularMarketPrice") quote.regularMarketPrice = value;
+        else if (currentKey == "regularMarketPreviousClose") quote.previousClose = value;
+        else if (currentKey == "regularMarketOpen") quote.regularMarketOpen = value;
+        else if (currentKey == "regularMarketDayHigh") quote.regularMarketDayHigh = value;
+        else if (currentKey == "regularMarketDayLow") quote.regularMarketDayLow = value;
+        else if (currentKey == "regularMarketVolume") quote.regularMarketVolume = value;
+        else if (currentKey == "regularMarketTime") quote.regularMarketTime = static_cast<int64_t>(value);
+        else if (currentKey == "gmtOffSetMilliseconds") quote.gmtOffset = static_cast<int64_t>(value) / 1000;
+    }
+
+    bool SawResult() const { return sawResult; }
+
+private:
+    enum Frame { OtherFrame, RootFrame, ResponseFrame, ResultArrayFrame, EntryFrame, ErrorFrame };
+
+    Frame Top() const {
+        return stack.empty() ? OtherFrame : stack.back();
+    }
+
+    void Open(bool isObject) {
+        Frame next = OtherFrame;
+        switch (Top()) {
+            case OtherFrame:
+                if (stack.empty() && isObject) next = RootFrame;
+                break;
+            case RootFrame:
+                if (isObject && currentKey == "quoteResponse") next = ResponseFrame;
+                break;
+            case ResponseFrame:
+                if (!isObject && currentKey == "result") {
+                    next = ResultArrayFrame;
+                    sawResult = true;
+                }
+                if (isObject && currentKey == "error") next = ErrorFrame;
+                break;
+            case ResultArrayFrame:
+                if (isObject) {
+                    next = EntryFrame;
+                    quotes.emplace_back();
+                }
+                break;
+            default:
+                break;
+        }
+        stack.push_back(next);
+        currentKey.clear();
+    }
+
+    void Close() {
+        if (!stack.empty()) {
+            stack.pop_back();
+        }
+        currentKey.clear();
+    }
+
+    std::vector<ChartMeta>& quotes;
+    std::string& error;
+    std::vector<Frame> stack;
+    std::string currentKey;  // copied: the reader may reuse a key's buffer
+    bool sawResult = false;
+};
+
+} // namespace
+
+bool ChartDecoder::Decode(const char* data, size_t length, ChartDocument& document) {
+    document = ChartDocument();
+
+    ChartHandler handler(document);
+    JsonReader reader;
+    if (!reader.Parse(data, length, handler)) {
+        document.error = "Malformed chart JSON: " + reader.Error();
+        return false;
+    }
+    if (!handler.SawResult()) {
+        if (document.error.empty()) {
+            document.error = "Chart response has no result";
+        }
+        return false;
+    }
+
+    handler.BuildBars();
+    return true;
+}
+
+bool ChartDecoder::DecodeQuotes(const char* data, size_t length,
+                                std::vector<ChartMeta>& quotes, std::string& error) {
+    quotes.clear();
+    error.clear();
+
+    QuoteListHandler handler(quotes, error);
+    JsonReader reader;
+    if (!reader.Parse(data, length, handler)) {
+        error = "Malformed quote JSON: " + reader.Error();
+        return false;
+    }
+    if (!handler.SawResult()) {
+        if (error.empty()) {
+            error = "Quote response has no result";
+        }
+        return false;
+    }
+
+    // Entries without a symbol cannot be matched to a request
+    quotes.erase(std::remove_if(quotes.begin(), quotes.end(),
+                                [](const ChartMeta& quote) { return quote.symbol.empty(); }),
+                 quotes.end());
+    return true;
+}
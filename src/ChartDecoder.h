@@ -0,0 +1,53 @@
+#pragma once
+#include "PriceSeries.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Fields of the v8 chart `meta` object, or of one v7 quote entry (which
+// carries the same figures); NaN (or 0 for the integers) when the payload
+// does not carry them
+struct ChartMeta {
+    std::string symbol;
+    double regularMarketPrice = NAN;
+    double regularMarketOpen = NAN;
+    double previousClose = NAN;
+    double chartPreviousClose = NAN;
+    double regularMarketDayHigh = NAN;
+    double regularMarketDayLow = NAN;
+    double regularMarketVolume = NAN;
+    int64_t regularMarketTime = 0;  // UNIX seconds
+    int64_t gmtOffset = 0;          // exchange offset from UTC in seconds
+};
+
+// Decoded v8 chart response (query1.finance.yahoo.com/v8/finance/chart/...)
+struct ChartDocument {
+    ChartMeta meta;
+    PriceSeries bars;   // timestamp + indicators.quote[0], rows with nulls dropped
+    std::string error;  // chart.error.description when the API reported one
+};
+
+// Decodes a chart payload in one pass with JsonReader. Only the first
+// entry of chart.result is read. Bar dates are the exchange-local day of
+// each timestamp.
+class ChartDecoder {
+public:
+    // Returns false if the JSON is malformed or has no chart.result;
+    // `document.error` then says why
+    static bool Decode(const char* data, size_t length, ChartDocument& document);
+    static bool Decode(const std::string& json, ChartDocument& document) {
+        return Decode(json.data(), json.size(), document);
+    }
+
+    // Decodes a multi-symbol v7 quote response (quoteResponse.result[]) into
+    // one entry per symbol the API returned. Returns false if the JSON is
+    // malformed or has no result list; `error` then says why.
+    static bool DecodeQuotes(const char* data, size_t length,
+                             std::vector<ChartMeta>& quotes, std::string& error);
+    static bool DecodeQuotes(const std::string& json, std::vector<ChartMeta>& quotes,
+                             std::string& error) {
+        return DecodeQuotes(json.data(), json.size(), quotes, error);
+    }
+};
@@ -0,0 +1,199 @@
+#include "ColumnStore.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#ifdef _WIN32
+#include <memory>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char Magic[8] = {'S', 'T', 'K', 'C', 'O', 'L', 'S', '\0'};
+const uint32_t ByteOrderMark = 0x01020304;
+
+uint64_t AlignUp(uint64_t offset, uint64_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+// Read-only view of a whole file. Owned through a shared_ptr by every
+// column that borrows from it, so the mapping lives as long as any view.
+class MappedFile {
+public:
+    ~MappedFile() {
+#ifndef _WIN32
+        if (address != nullptr) {
+            munmap(address, length);
+        }
+#endif
+    }
+
+    bool Open(const std::string& filepath) {
+#ifdef _WIN32
+        std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+        length = static_cast<size_t>(file.tellg());
+        buffer.reset(new uint64_t[length / sizeof(uint64_t) + 1]);
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(buffer.get()), length);
+        address = buffer.get();
+        return static_cast<bool>(file);
+#else
+        int fd = open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+            close(fd);
+            return false;
+        }
+        length = static_cast<size_t>(info.st_size);
+
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);  // the mapping keeps its own reference
+        if (mapped == MAP_FAILED) return false;
+
+        address = mapped;
+        return true;
+#endif
+    }
+
+    const char* Data() const { return static_cast<const char*>(address); }
+    size_t Size() const { return length; }
+
+private:
+    void* address = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    std::unique_ptr<uint64_t[]> buffer;
+#endif
+};
+
+} // namespace
+
+bool ColumnStore::Write(const std::string& filepath, const PriceSeries& series) {
+    const uint64_t rows = series.size();
+
+    ColumnStoreHeader header = {};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = FormatVersion;
+    header.byteOrderMark = ByteOrderMark;
+    header.rowCount = rows;
+    header.columnCount = ColumnCount;
+
+    uint64_t offset = sizeof(ColumnStoreHeader);
+    const uint64_t widths[ColumnCount] = {
+        sizeof(int32_t), sizeof(double), sizeof(double),
+        sizeof(double), sizeof(double), sizeof(double)
+    };
+    for (uint32_t c = 0; c < ColumnCount; ++c) {
+        offset = AlignUp(offset, ColumnAlignment);
+        header.columnOffset[c] = offset;
+        offset += widths[c] * rows;
+    }
+
+    const void* columns[ColumnCount] = {
+        series.date.data(), series.open.data(), series.high.data(),
+        series.low.data(), series.close.data(), series.volume.data()
+    };
+
+    std::string tempPath = filepath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open " << tempPath << " for writing\n";
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        uint64_t written = sizeof(header);
+        const char padding[ColumnAlignment] = {};
+        for (uint32_t c = 0; c < ColumnCount; ++c) {
+            file.write(padding, static_cast<std::streamsize>(header.columnOffset[c] - written));
+            file.write(static_cast<const char*>(columns[c]),
+                       static_cast<std::streamsize>(widths[c] * rows));
+            written = header.columnOffset[c] + widths[c] * rows;
+        }
+
+        if (!file) {
+            std::cerr << "Error: Failed writing column store " << tempPath << "\n";
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+#ifdef _WIN32
+    std::remove(filepath.c_str());
+#endif
+    if (std::rename(tempPath.c_str(), filepath.c_str()) != 0) {
+        std::cerr << "Error: Could not move " << tempPath << " to " << filepath << "\n";
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+PriceSeries ColumnStore::Map(const std::string& filepath) {
+    PriceSeries series;
+
+    auto file = std::make_shared<MappedFile>();
+    if (!file->Open(filepath)) {
+        std::cerr << "Error: Could not map column store " << filepath << "\n";
+        return series;
+    }
+
+    if (file->Size() < sizeof(ColumnStoreHeader)) {
+        std::cerr << "Error: " << filepath << " is too small to be a column store\n";
+        return series;
+    }
+
+    ColumnStoreHeader header;
+    std::memcpy(&header, file->Data(), sizeof(header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0) {
+        std::cerr << "Error: " << filepath << " is not a column store\n";
+        return series;
+    }
+    if (header.byteOrderMark != ByteOrderMark) {
+        std::cerr << "Error: " << filepath << " was written with a different byte order\n";
+        return series;
+    }
+    if (header.version != FormatVersion || header.columnCount != ColumnCount) {
+        std::cerr << "Error: Unsupported column store version " << header.version
+                  << " in " << filepath << "\n";
+        return series;
+    }
+
+    const uint64_t rows = header.rowCount;
+    const uint64_t widths[ColumnCount] = {
+        sizeof(int32_t), sizeof(double), sizeof(double),
+        sizeof(double), sizeof(double), sizeof(double)
+    };
+    for (uint32_t c = 0; c < ColumnCount; ++c) {
+        uint64_t begin = header.columnOffset[c];
+        if (begin % ColumnAlignment != 0 || begin > file->Size() ||
+            rows > (file->Size() - begin) / widths[c]) {
+            std::cerr << "Error: Corrupt column directory in " << filepath << "\n";
+            return series;
+        }
+    }
+
+    const char* base = file->Data();
+    auto doubles = [&](uint32_t c) {
+        return Column<double>::Borrow(
+            reinterpret_cast<const double*>(base + header.columnOffset[c]), rows, file);
+    };
+    series.date = Column<int32_t>::Borrow(
+        reinterpret_cast<const int32_t*>(base + header.columnOffset[0]), rows, file);
+    series.open = doubles(1);
+    series.high = doubles(2);
+    series.low = doubles(3);
+    series.close = doubles(4);
+    series.volume = doubles(5);
+    return series;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "PriceSeries.h"
+#include <cstdint>
+#include <string>
+
+// Versioned on-disk format for one ticker's OHLCV history.
+//
+// Layout (little-endian):
+//   [0, 128)      ColumnStoreHeader
+//   columnOffset  date column (int32_t x rowCount)
+//   columnOffset  open/high/low/close/volume columns (double x rowCount)
+// Every column starts on a 64-byte boundary so a mapped file can be handed
+// to the indicator kernels without copying or realigning.
+struct ColumnStoreHeader {
+    char magic[8];              // "STKCOLS\0"
+    uint32_t version;           // ColumnStore::FormatVersion
+    uint32_t byteOrderMark;     // 0x01020304 as written by the producer
+    uint64_t rowCount;
+    uint32_t columnCount;       // ColumnStore::ColumnCount
+    uint32_t reserved0;
+    uint64_t columnOffset[6];   // date, open, high, low, close, volume
+    uint8_t reserved[48];
+};
+static_assert(sizeof(ColumnStoreHeader) == 128, "ColumnStoreHeader must stay 128 bytes");
+
+class ColumnStore {
+public:
+    static constexpr uint32_t FormatVersion = 1;
+    static constexpr uint32_t ColumnCount = 6;
+    static constexpr uint64_t ColumnAlignment = 64;
+
+    // Writes `series` to `filepath` (via a temporary file and rename, so
+    // readers never observe a half-written store)
+    static bool Write(const std::string& filepath, const PriceSeries& series);
+
+    // Maps `filepath` read-only and returns a PriceSeries whose columns
+    // borrow the mapping. Returns an empty series on any error.
+    static PriceSeries Map(const std::string& filepath);
+};
@@ -2,6 +2,7 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 
 Config& Config::GetInstance() {
     static Config instance;
@@ -39,6 +40,96 @@ bool Config::LoadFromFile(const std::string& filepath) {
                     defaultTicker = line.substr(quote1 + 1, quote2 - quote1 - 1);
                 }
             }
+        } else if (line.find("\"loader_threads\"") != std::string::npos) {
+            size_t start = line.find(':');
+            if (start != std::string::npos) {
+                try {
+                    loaderThreads = std::max(0, std::stoi(line.substr(start + 1)));
+                } catch (const std::exception&) {
+                    std::cerr << "Warning: Invalid loader_threads value\n";
+                }
+            }
+        } else if (line.find("\"max_in_flight\"") != std::string::npos) {
+            size_t start = line.find(':');
+            if (start != std::string::npos) {
+                try {
+                    maxInFlight = std::max(1, std::stoi(line.substr(start + 1)));
+                } catch (const std::exception&) {
+                    std::cerr << "Warning: Invalid max_in_flight value\n";
+                }
+            }
+        } else if (line.find("\"max_per_host\"") != std::string::npos) {
+            size_t start = line.find(':');
+            if (start != std::string::npos) {
+                try {
+                    maxPerHost = std::max(1, std::stoi(line.substr(start + 1)));
+                } catch (const std::exception&) {
+                    std::cerr << "Warning: Invalid max_per_host value\n";
+                }
+            }
+        } else if (line.find("\"base_url\"") != std::string::npos) {
+            size_t start = line.find(':');
+            if (start != std::string::npos) {
+                size_t quote1 = line.find('"', start);
+                size_t quote2 = line.find('"', quote1 + 1);
+                if (quote1 != std::string::npos && quote2 != std::string::npos) {
+                    apiBaseURL = line.substr(quote1 + 1, quote2 - quote1 - 1);
+                }
+            }
+        } else if (line.find("\"history_source\"") != std::string::npos) {
+            size_t start = line.find(':');
+            if (start != std::string::npos) {
+                size_t quote1 = line.find('"', start);
+                size_t quote2 = line.find('"', quote1 + 1);
+                if (quote1 != std::string::npos && quote2 != std::string::npos) {
+                    historySource = line.substr(quote1 + 1, quote2 - quote1 - 1);
+                }
+            }
+        } else if (line.find("\"http_mode\"") != std::string::npos) {
+            size_t start = line.find(':');
+            if (start != std::string::npos) {
+                size_t quote1 = line.find('"', start);
+                size_t quote2 = line.find('"', quote1 + 1);
+                if (quote1 != std::string::npos && quote2 != std::string::npos) {
+                    httpMode = line.substr(quote1 + 1, quote2 - quote1 - 1);
+                }
+            }
+        } else if (line.find("\"fixture_dir\"") != std::string::npos) {
+            size_t start = line.find(':');
+            if (start != std::string::npos) {
+                size_t quote1 = line.find('"', start);
+                size_t quote2 = line.find('"', quote1 + 1);
+                if (quote1 != std::string::npos && quote2 != std::string::npos) {
+                    fixtureDirectory = line.substr(quote1 + 1, quote2 - quote1 - 1);
+                }
+            }
+        } else if (line.find("\"history_cache_dir\"") != std::string::npos) {
+            size_t start = line.find(':');
+            if (start != std::string::npos) {
+                size_t quote1 = line.find('"', start);
+                size_t quote2 = line.find('"', quote1 + 1);
+                if (quote1 != std::string::npos && quote2 != std::string::npos) {
+                    historyCacheDirectory = line.substr(quote1 + 1, quote2 - quote1 - 1);
+                }
+            }
+        } else if (line.find("\"replay_latency_ms\"") != std::string::npos) {
+            size_t start = line.find(':');
+            if (start != std::string::npos) {
+                try {
+                    replayLatencyMs = std::max(0, std::stoi(line.substr(start + 1)));
+                } catch (const std::exception&) {
+                    std::cerr << "Warning: Invalid replay_latency_ms value\n";
+                }
+            }
+        } else if (line.find("\"replay_bandwidth_kbps\"") != std::string::npos) {
+            size_t start = line.find(':');
+            if (start != std::string::npos) {
+                try {
+                    replayBandwidthKBps = std::max(0, std::stoi(line.substr(start + 1)));
+                } catch (const std::exception&) {
+                    std::cerr << "Warning: Invalid replay_bandwidth_kbps value\n";
+                }
+            }
         }
         // Add more parsing as needed
         // For now, this is a basic implementation
@@ -27,6 +27,16 @@ public:
     
     int GetAPITimeout() const { return apiTimeout; }
     int GetAPIRetryCount() const { return apiRetryCount; }
+    int GetLoaderThreads() const { return loaderThreads; }
+    int GetMaxInFlight() const { return maxInFlight; }
+    int GetMaxPerHost() const { return maxPerHost; }
+    std::string GetAPIBaseURL() const { return apiBaseURL; }
+    std::string GetHistorySource() const { return historySource; }
+    std::string GetHttpMode() const { return httpMode; }
+    std::string GetFixtureDirectory() const { return fixtureDirectory; }
+    std::string GetHistoryCacheDirectory() const { return historyCacheDirectory; }
+    int GetReplayLatencyMs() const { return replayLatencyMs; }
+    int GetReplayBandwidthKBps() const { return replayBandwidthKBps; }
     
     bool UsePython() const { return usePython; }
     std::string GetPythonScript() const { return pythonScript; }
@@ -56,6 +66,16 @@ private:
     
     int apiTimeout = 30;
     int apiRetryCount = 3;
+    int loaderThreads = 0;  // 0 = one per hardware thread
+    int maxInFlight = 32;   // concurrent requests in a batch fetch
+    int maxPerHost = 6;     // open connections per host in a batch fetch
+    std::string apiBaseURL = "https://query1.finance.yahoo.com";
+    std::string historySource = "csv";  // "csv" (v7 download) or "chart" (v8 JSON)
+    std::string httpMode = "live";      // "live", "record" or "replay"
+    std::string fixtureDirectory = "fixtures";
+    std::string historyCacheDirectory;  // empty = no on-disk history cache
+    int replayLatencyMs = 0;            // simulated per-request latency in replay
+    int replayBandwidthKBps = 0;        // simulated per-request throughput, 0 = unlimited
     
     bool usePython = true;
     std::string pythonScript = "scripts/plot_data.py";
@@ -0,0 +1,128 @@
+#include "CovarianceEngine.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+constexpr size_t TileBytes = 512 * 1024;
+
+struct Tile {
+    size_t rowBegin, rowEnd;
+    size_t columnBegin, columnEnd;
+};
+
+} // namespace
+
+CovarianceEngine::CovarianceEngine(size_t workerCount)
+    : workers(workerCount == 0 ? ThreadPool::DefaultWorkerCount() : workerCount) {}
+
+size_t CovarianceEngine::TileRows(size_t length) {
+    size_t rows = TileBytes / (2 * sizeof(double) * std::max<size_t>(length, 1));
+    return std::min<size_t>(256, std::max<size_t>(8, rows));
+}
+
+CovarianceEngine::Matrices CovarianceEngine::Compute(const std::vector<std::vector<double>>& series,
+                                                     bool withCorrelation) const {
+    if (series.empty()) {
+        std::cerr << "Error: No series for covariance matrix\n";
+        return Matrices();
+    }
+    const size_t m = series[0].size();
+    for (const auto& row : series) {
+        if (row.size() != m) {
+            std::cerr << "Error: Inconsistent returns matrix dimensions\n";
+            return Matrices();
+        }
+    }
+    return Compute(series.size(), m, [&series](size_t i) { return series[i].data(); }, withCorrelation);
+}
+
+CovarianceEngine::Matrices CovarianceEngine::Compute(const Panel& panel, bool withCorrelation) const {
+    if (panel.StorageLayout() != Panel::Layout::ColumnMajor) {
+        return Compute(panel.WithLayout(Panel::Layout::ColumnMajor), withCorrelation);
+    }
+    if (panel.ValidCount() != panel.Tickers() * panel.Dates()) {
+        std::cerr << "Error: Covariance matrix needs a panel without missing values\n";
+        return Matrices();
+    }
+    return Compute(panel.Tickers(), panel.Dates(),
+                   [&panel](size_t i) { return panel.Column(i).data(); }, withCorrelation);
+}
+
+CovarianceEngine::Matrices CovarianceEngine::Compute(size_t n, size_t m,
+                                                     const std::function<const double*(size_t)>& seriesAt,
+                                                     bool withCorrelation) const {
+    Matrices result;
+    if (n == 0) {
+        std::cerr << "Error: No series for covariance matrix\n";
+        return result;
+    }
+    if (m < 2) {
+        std::cerr << "Error: Need at least two observations for covariance matrix\n";
+        return result;
+    }
+
+    // Center once into an aligned panel; x - mean is the same value the
+    // pairwise kernels form, so dot products of centered columns
+    // reproduce them exactly
+    Panel centered{std::vector<std::string>(n), std::vector<int32_t>(m)};
+    for (size_t i = 0; i < n; ++i) {
+        const double* values = seriesAt(i);
+        double mean = SimdKernels::Sum(values, m) / m;
+        double* out = centered.Column(i).data();
+        for (size_t t = 0; t < m; ++t) {
+            out[t] = values[t] - mean;
+        }
+    }
+
+    const size_t block = TileRows(m);
+    std::vector<Tile> tiles;
+    for (size_t r = 0; r < n; r += block) {
+        for (size_t c = r; c < n; c += block) {
+            tiles.push_back({r, std::min(n, r + block), c, std::min(n, c + block)});
+        }
+    }
+
+    // Upper triangle of the cross products, row-major; tiles write
+    // disjoint entries
+    std::vector<double> sums(n * n);
+    auto runTile = [&](size_t index) {
+        const Tile& tile = tiles[index];
+        for (size_t i = tile.rowBegin; i < tile.rowEnd; ++i) {
+            const double* x = centered.Column(i).data();
+            for (size_t j = std::max(i, tile.columnBegin); j < tile.columnEnd; ++j) {
+                sums[i * n + j] = SimdKernels::SumCrossDeviations(x, centered.Column(j).data(), m, 0.0, 0.0);
+            }
+        }
+    };
+    size_t threads = std::min(workers, tiles.size());
+    if (threads <= 1) {
+        for (size_t index = 0; index < tiles.size(); ++index) {
+            runTile(index);
+        }
+    } else {
+        ThreadPool pool(threads);
+        pool.ParallelFor(tiles.size(), runTile);
+    }
+
+    result.covariance.assign(n, std::vector<double>(n));
+    if (withCorrelation) {
+        result.correlation.assign(n, std::vector<double>(n));
+    }
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i; j < n; ++j) {
+            double sum = sums[i * n + j];
+            result.covariance[i][j] = result.covariance[j][i] = sum / (m - 1);
+            if (withCorrelation) {
+                double denominator = std::sqrt(sums[i * n + i] * sums[j * n + j]);
+                double correlation = denominator == 0.0 ? 0.0 : sum / denominator;
+                result.correlation[i][j] = result.correlation[j][i] = correlation;
+            }
+        }
+    }
+    result.success = true;
+    return result;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "Panel.h"
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// Covariance and correlation matrices of a panel of equal-length series
+// (one per stock, e.g. aligned daily returns).
+//
+// The series are centered once into an aligned column-major Panel. Only the
+// upper triangle of the cross-product matrix is computed, tile by tile:
+// each tile pairs a block of series with another block small enough that
+// both stay in cache while every dot product between them is taken, and
+// the tiles are spread over a ThreadPool. Covariance and correlation both
+// come from that single pass and are mirrored into full matrices.
+//
+// Entries are bit-identical to DataProcessor::CalculateCorrelation and to
+// the sample covariance computed pair by pair, whatever the worker count.
+class CovarianceEngine {
+public:
+    // 0 means one worker per hardware thread
+    explicit CovarianceEngine(size_t workerCount = 0);
+
+    struct Matrices {
+        std::vector<std::vector<double>> covariance;   // sample (n - 1) covariance
+        std::vector<std::vector<double>> correlation;  // empty unless requested
+        bool success = false;
+    };
+
+    // Fails (with a message on stderr) for an empty panel, ragged rows or
+    // rows shorter than two values. A constant row has zero correlation
+    // with everything, itself included, as in CalculateCorrelation.
+    Matrices Compute(const std::vector<std::vector<double>>& series, bool withCorrelation = true) const;
+    // One series per ticker; the panel must have no invalid cells
+    Matrices Compute(const Panel& panel, bool withCorrelation = true) const;
+
+    // Rows per tile for rows of `length` values: two blocks of this many
+    // rows fit in about half of a typical L2 cache
+    static size_t TileRows(size_t length);
+
+private:
+    Matrices Compute(size_t n, size_t m, const std::function<const double*(size_t)>& seriesAt,
+                     bool withCorrelation) const;
+
+    size_t workers;
+};
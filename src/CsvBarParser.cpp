@@ -0,0 +1,203 @@
+#include "CsvBarParser.h"
+#include "CsvScan.h"
+#include "DateUtil.h"
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+namespace {
+
+std::string_view Trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '"')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '"')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Mirrors std::stod: leading blanks and a valid numeric prefix are enough
+bool ParseNumber(std::string_view text, double& value) {
+    text = Trim(text);
+    return CsvScan::ParseDouble(text.data(), text.data() + text.size(), value);
+}
+
+// Splits one line into at most `maxColumns` fields; returns the field count
+int SplitLine(const char* begin, const char* end, std::string_view* fields, int maxColumns) {
+    int count = 0;
+    const char* cell = begin;
+    while (count < maxColumns) {
+        const char* comma = static_cast<const char*>(std::memchr(cell, ',', end - cell));
+        const char* cellEnd = comma ? comma : end;
+        fields[count++] = std::string_view(cell, cellEnd - cell);
+        if (!comma) break;
+        cell = comma + 1;
+    }
+    return count;
+}
+
+} // namespace
+
+CsvBarParser::CsvBarParser(PriceSeries& series, bool validateRows)
+    : output(series), validate(validateRows) {
+    // Yahoo layout until a header says otherwise:
+    // Date,Open,High,Low,Close,Adj Close,Volume
+    fieldColumn[DateField] = 0;
+    fieldColumn[OpenField] = 1;
+    fieldColumn[HighField] = 2;
+    fieldColumn[LowField] = 3;
+    fieldColumn[CloseField] = 4;
+    fieldColumn[VolumeField] = 6;
+    maxColumn = 6;
+}
+
+void CsvBarParser::Feed(const char* data, size_t length) {
+    // Blocks keep structural offsets within 32 bits and bound the index buffer
+    while (length > 0) {
+        size_t blockLength = length < BlockSize ? length : BlockSize;
+        FeedBlock(data, blockLength);
+        data += blockLength;
+        length -= blockLength;
+    }
+}
+
+void CsvBarParser::FeedBlock(const char* data, size_t length) {
+    if (structural.size() < length) {
+        structural.resize(BlockSize);
+    }
+    size_t count = CsvScan::FindStructural(data, length, structural.data());
+    size_t next = 0;
+    size_t lineStart = 0;
+
+    // Complete a line left over from the previous block
+    if (!pending.empty()) {
+        while (next < count && data[structural[next]] != '\n') ++next;
+        if (next == count) {
+            pending.append(data, length);
+            return;
+        }
+        pending.append(data, structural[next]);
+        ProcessLine(pending.data(), pending.data() + pending.size());
+        pending.clear();
+        lineStart = structural[next] + 1;
+        ++next;
+    }
+
+    // Whole lines are cut into fields in place, straight out of the caller's buffer
+    std::string_view fields[MaxColumns];
+    int fieldCount = 0;
+    size_t fieldStart = lineStart;
+    for (; next < count; ++next) {
+        size_t position = structural[next];
+        if (fieldCount < MaxColumns) {
+            fields[fieldCount++] = std::string_view(data + fieldStart, position - fieldStart);
+        }
+        fieldStart = position + 1;
+        if (data[position] == '\n') {
+            ProcessFields(fields, fieldCount);
+            fieldCount = 0;
+            lineStart = fieldStart;
+        }
+    }
+
+    if (lineStart < length) {
+        pending.assign(data + lineStart, length - lineStart);
+    }
+}
+
+void CsvBarParser::Finish() {
+    if (!pending.empty()) {
+        ProcessLine(pending.data(), pending.data() + pending.size());
+        pending.clear();
+    }
+}
+
+void CsvBarParser::ProcessLine(const char* begin, const char* end) {
+    std::string_view fields[MaxColumns];
+    int count = SplitLine(begin, end, fields, MaxColumns);
+    ProcessFields(fields, count);
+}
+
+void CsvBarParser::ProcessFields(std::string_view* fields, int count) {
+    std::string_view& last = fields[count - 1];
+    if (!last.empty() && last.back() == '\r') last.remove_suffix(1);
+    if (count == 1 && last.empty()) return;
+
+    if (!headerSeen) {
+        headerSeen = true;
+        ProcessHeader(fields, count);
+        return;
+    }
+    ProcessRow(fields, count);
+}
+
+void CsvBarParser::ProcessHeader(const std::string_view* fields, int count) {
+    static const char* const names[FieldCount] = {"Date", "Open", "High", "Low", "Close", "Volume"};
+    int found[FieldCount];
+    bool allFound = true;
+    for (int f = 0; f < FieldCount; ++f) {
+        found[f] = -1;
+        for (int c = 0; c < count; ++c) {
+            if (Trim(fields[c]) == names[f]) {
+                found[f] = c;
+                break;
+            }
+        }
+        allFound = allFound && found[f] >= 0;
+    }
+
+    // Unrecognized headers keep the positional Yahoo layout
+    if (!allFound) return;
+
+    maxColumn = 0;
+    for (int f = 0; f < FieldCount; ++f) {
+        fieldColumn[f] = found[f];
+        if (found[f] > maxColumn) maxColumn = found[f];
+    }
+}
+
+void CsvBarParser::ProcessRow(const std::string_view* fields, int count) {
+    size_t row = rowsRead++;
+
+    if (count <= maxColumn) {
+        if (validate) {
+            std::cerr << "Warning: Row " << row << " has too few columns, skipping\n";
+        }
+        return;
+    }
+
+    StockData bar;
+    std::string_view dateText = Trim(fields[fieldColumn[DateField]]);
+    if (!DateUtil::ParseDate(dateText.data(), dateText.size(), bar.date)) {
+        if (validate) {
+            std::cerr << "Warning: Row " << row << " has an invalid date, skipping\n";
+        }
+        return;
+    }
+
+    if (!ParseNumber(fields[fieldColumn[OpenField]], bar.open) ||
+        !ParseNumber(fields[fieldColumn[HighField]], bar.high) ||
+        !ParseNumber(fields[fieldColumn[LowField]], bar.low) ||
+        !ParseNumber(fields[fieldColumn[CloseField]], bar.close) ||
+        !ParseNumber(fields[fieldColumn[VolumeField]], bar.volume)) {
+        if (validate) {
+            std::cerr << "Warning: Row " << row << " has non-numeric values, skipping\n";
+        }
+        return;
+    }
+
+    if (validate) {
+        if (bar.high < bar.low) {
+            std::cerr << "Warning: Row " << row << " has High < Low, skipping\n";
+            return;
+        }
+        if (bar.open <= 0 || bar.close <= 0 || bar.volume < 0) {
+            std::cerr << "Warning: Row " << row << " has invalid values, skipping\n";
+            return;
+        }
+    }
+
+    output.push_back(bar);
+    ++rowsAccepted;
+}
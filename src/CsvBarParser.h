@@ -0,0 +1,57 @@
+#pragma once
+#include "PriceSeries.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Incremental parser for OHLCV CSV text (Date,Open,High,Low,Close,...,Volume).
+// Bytes may be pushed in chunks of any size; complete lines are tokenized in
+// place and appended straight into the output PriceSeries, so the document
+// is never materialized. Only a partial trailing line is buffered between
+// chunks.
+//
+// Each block is first scanned with CsvScan::FindStructural (SIMD when
+// available) to locate every ',' and '\n', and fields are then converted
+// with CsvScan::ParseDouble, so steady-state parsing does not allocate.
+class CsvBarParser {
+public:
+    // With `validateRows`, rows with High < Low or non-positive prices are
+    // rejected with a warning (the LoadFromCSV policy); otherwise only rows
+    // that fail to parse are dropped (the ParseCSV policy).
+    explicit CsvBarParser(PriceSeries& output, bool validateRows = false);
+
+    void Feed(const char* data, size_t length);
+
+    // Flushes a final line that has no trailing newline
+    void Finish();
+
+    // Whether a header line has been read, i.e. the input looked like CSV
+    bool HeaderSeen() const { return headerSeen; }
+
+    // Data rows seen (header excluded) and rows appended to the output
+    size_t RowsRead() const { return rowsRead; }
+    size_t RowsAccepted() const { return rowsAccepted; }
+
+private:
+    enum Field { DateField, OpenField, HighField, LowField, CloseField, VolumeField, FieldCount };
+    static const int MaxColumns = 32;
+    static const size_t BlockSize = 64 * 1024;
+
+    void FeedBlock(const char* data, size_t length);
+    void ProcessLine(const char* begin, const char* end);
+    void ProcessFields(std::string_view* fields, int count);
+    void ProcessHeader(const std::string_view* fields, int count);
+    void ProcessRow(const std::string_view* fields, int count);
+
+    PriceSeries& output;
+    bool validate;
+    bool headerSeen = false;
+    int fieldColumn[FieldCount];
+    int maxColumn = 0;
+    std::string pending;
+    std::vector<uint32_t> structural;  // delimiter offsets for one block
+    size_t rowsRead = 0;
+    size_t rowsAccepted = 0;
+};
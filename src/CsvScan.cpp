@@ -0,0 +1,213 @@
+#include "CsvScan.h"
+#include <cfloat>
+#include <charconv>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CSVSCAN_X86 1
+#endif
+
+namespace CsvScan {
+
+namespace {
+
+size_t FindStructuralScalar(const char* data, size_t length, uint32_t* positions) {
+    size_t count = 0;
+    for (size_t i = 0; i < length; ++i) {
+        char c = data[i];
+        if (c == ',' || c == '\n') {
+            positions[count++] = static_cast<uint32_t>(i);
+        }
+    }
+    return count;
+}
+
+#ifdef CSVSCAN_X86
+
+inline size_t EmitMask(uint32_t mask, size_t base, uint32_t* positions, size_t count) {
+    while (mask != 0) {
+        positions[count++] = static_cast<uint32_t>(base + __builtin_ctz(mask));
+        mask &= mask - 1;
+    }
+    return count;
+}
+
+__attribute__((target("sse2")))
+size_t FindStructuralSSE2(const char* data, size_t length, uint32_t* positions) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(block, comma), _mm_cmpeq_epi8(block, newline));
+        count = EmitMask(static_cast<uint32_t>(_mm_movemask_epi8(hits)), i, positions, count);
+    }
+    for (; i < length; ++i) {
+        if (data[i] == ',' || data[i] == '\n') {
+            positions[count++] = static_cast<uint32_t>(i);
+        }
+    }
+    return count;
+}
+
+__attribute__((target("avx2")))
+size_t FindStructuralAVX2(const char* data, size_t length, uint32_t* positions) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(block, comma),
+                                       _mm256_cmpeq_epi8(block, newline));
+        count = EmitMask(static_cast<uint32_t>(_mm256_movemask_epi8(hits)), i, positions, count);
+    }
+    for (; i < length; ++i) {
+        if (data[i] == ',' || data[i] == '\n') {
+            positions[count++] = static_cast<uint32_t>(i);
+        }
+    }
+    return count;
+}
+
+#endif // CSVSCAN_X86
+
+using FindStructuralFn = size_t (*)(const char*, size_t, uint32_t*);
+
+struct Implementation {
+    FindStructuralFn find;
+    const char* name;
+};
+
+Implementation SelectImplementation() {
+#ifdef CSVSCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return { FindStructuralAVX2, "avx2" };
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return { FindStructuralSSE2, "sse2" };
+    }
+#endif
+    return { FindStructuralScalar, "scalar" };
+}
+
+const Implementation& Active() {
+    static const Implementation implementation = SelectImplementation();
+    return implementation;
+}
+
+// Exact powers of ten representable as doubles
+const double PowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+const uint64_t MaxExactMantissa = uint64_t(1) << 53;
+
+// The fast path relies on double arithmetic rounding once per operation;
+// x87 extended precision (FLT_EVAL_METHOD != 0) would round twice
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+const bool ExactDoubleArithmetic = true;
+#else
+const bool ExactDoubleArithmetic = false;
+#endif
+
+} // namespace
+
+size_t FindStructural(const char* data, size_t length, uint32_t* positions) {
+    return Active().find(data, length, positions);
+}
+
+const char* ActiveImplementation() {
+    return Active().name;
+}
+
+bool ParseDouble(const char* begin, const char* end, double& value) {
+    const char* p = begin;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    // Clinger's fast path: when the decimal mantissa fits in 53 bits and the
+    // power of ten is itself exact, one multiply or divide is correctly rounded
+    uint64_t mantissa = 0;
+    int digits = 0;          // significant digits accumulated into mantissa
+    int exponent = 0;
+    bool sawDigit = false;
+    bool overflow = false;
+
+    for (; p < end && static_cast<unsigned>(*p - '0') <= 9; ++p) {
+        sawDigit = true;
+        if (mantissa == 0 && *p == '0') continue;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+            ++digits;
+        } else {
+            overflow = true;
+        }
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        for (; p < end && static_cast<unsigned>(*p - '0') <= 9; ++p) {
+            sawDigit = true;
+            if (mantissa == 0 && *p == '0') {
+                --exponent;
+                continue;
+            }
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                ++digits;
+                --exponent;
+            } else {
+                overflow = true;
+            }
+        }
+    }
+    if (!sawDigit) {
+        // inf, nan and other spellings (but never a second sign)
+        if (p < end && (*p == '+' || *p == '-')) return false;
+        const char* start = begin + (begin < end && *begin == '+');
+        auto result = std::from_chars(start, end, value);
+        return result.ec == std::errc() && result.ptr != start;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool negativeExponent = false;
+        if (q < end && (*q == '+' || *q == '-')) {
+            negativeExponent = *q == '-';
+            ++q;
+        }
+        if (q < end && static_cast<unsigned>(*q - '0') <= 9) {
+            int explicitExponent = 0;
+            for (; q < end && static_cast<unsigned>(*q - '0') <= 9; ++q) {
+                if (explicitExponent < 100000) {
+                    explicitExponent = explicitExponent * 10 + (*q - '0');
+                }
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+    }
+
+    if (ExactDoubleArithmetic && !overflow && mantissa <= MaxExactMantissa && exponent >= -22 && exponent <= 22) {
+        double result = static_cast<double>(mantissa);
+        if (exponent < 0) {
+            result /= PowersOfTen[-exponent];
+        } else {
+            result *= PowersOfTen[exponent];
+        }
+        value = negative ? -result : result;
+        return true;
+    }
+
+    // Slow path: defer to the correctly rounded library conversion
+    const char* start = begin + (begin < end && *begin == '+');
+    auto result = std::from_chars(start, end, value);
+    return result.ec == std::errc() && result.ptr != start;
+}
+
+} // namespace CsvScan
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Low-level scanning primitives behind CsvBarParser.
+namespace CsvScan {
+
+// Writes the offset (relative to `data`) of every ',' and '\n' in
+// [data, data + length) to `positions`, in order, and returns how many were
+// found. `positions` must have room for `length` entries and `length` must
+// fit in 32 bits. Uses AVX2 or SSE2 when the CPU supports it (chosen once at
+// runtime) and a scalar loop otherwise; all variants give identical output.
+size_t FindStructural(const char* data, size_t length, uint32_t* positions);
+
+// Name of the implementation FindStructural dispatches to ("avx2", "sse2"
+// or "scalar")
+const char* ActiveImplementation();
+
+// Parses the longest numeric prefix of [begin, end) like std::strtod
+// (optional sign, digits, fraction, exponent; also inf/nan). Decimals whose
+// digits fit in 53 bits with a power of ten within 1e+-22 - i.e. any price
+// or volume in practice - are converted exactly without touching the
+// library; the rest fall back to std::from_chars, so results are always
+// correctly rounded. Returns false if no number could be read.
+bool ParseDouble(const char* begin, const char* end, double& value);
+
+} // namespace CsvScan
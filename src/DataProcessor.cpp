@@ -1,101 +1,337 @@
 #include "DataProcessor.h"
+#include "RollingStats.h"
+#include "CovarianceEngine.h"
+#include "PanelBuilder.h"
+#include "SimdKernels.h"
+#include "SymmetricEigen.h"
+#include "RandomizedPCA.h"
 #include <algorithm>
 #include <numeric>
 #include <cmath>
 #include <iostream>
 
-std::vector<double> DataProcessor::CalculateSMA(const std::vector<StockData>& data, int period) {
-    std::vector<double> sma;
-    if (data.size() < static_cast<size_t>(period)) {
-        return sma;
+namespace {
+
+// Bars per block in RunIndicatorPipeline: small enough that a block of
+// closes and the outputs derived from it stay in L1 between indicators
+const size_t PipelineBlock = 512;
+
+// Running state of one SMA or EMA inside RunIndicatorPipeline
+struct AverageState {
+    int period = 0;
+    double sum = 0.0;           // SMA: compensated window sum
+    double compensation = 0.0;
+    double value = 0.0;         // EMA: current average
+    double multiplier = 0.0;    // EMA: smoothing factor
+    size_t uses = 0;            // result slots that take this output
+    std::vector<double> output;
+};
+
+// Index of the state for `period` in `states`, adding one if needed
+size_t StateFor(std::vector<AverageState>& states, int period) {
+    for (size_t i = 0; i < states.size(); ++i) {
+        if (states[i].period == period) {
+            return i;
+        }
     }
-    
-    for (size_t i = period - 1; i < data.size(); ++i) {
-        double sum = 0.0;
-        for (int j = 0; j < period; ++j) {
-            sum += data[i - j].close;
+    states.emplace_back();
+    states.back().period = period;
+    return states.size() - 1;
+}
+
+// Hands out a state's output, moving it to the last slot that uses it
+std::vector<double> TakeOutput(AverageState& state) {
+    return --state.uses == 0 ? std::move(state.output) : state.output;
+}
+
+// Whether `out` can hold an output of `layout`; reports the ones that cannot
+bool Fits(Span<double> out, const DataProcessor::OutputLayout& layout, const char* indicator) {
+    if (out.size() >= layout.length) {
+        return layout.length > 0;
+    }
+    std::cerr << "Error: " << indicator << " buffer holds " << out.size()
+              << " values, " << layout.length << " needed\n";
+    return false;
+}
+
+// Annualized volatility of each `window` of returns (returnAt(i) is return
+// i), into out[0 .. returnCount - window]; returnCount >= window > 0
+template <typename ReturnAt>
+void RollingVolatility(ReturnAt returnAt, size_t returnCount, size_t window, double* out) {
+    const double annualize = std::sqrt(252.0);
+    RollingStats stats;
+    stats.RebuildFrom(window, returnAt);
+    out[0] = stats.StdDev() * annualize; // Annualized volatility
+    for (size_t i = window; i < returnCount; ++i) {
+        stats.Slide(returnAt(i), returnAt(i - window));
+        if (stats.NeedsRebuild()) {
+            size_t first = i + 1 - window;
+            stats.RebuildFrom(window, [&](size_t k) { return returnAt(first + k); });
         }
-        sma.push_back(sum / period);
+        out[i - window + 1] = stats.StdDev() * annualize;
     }
+}
+
+} // namespace
+
+DataProcessor::OutputLayout DataProcessor::SMALayout(size_t count, int period) {
+    if (period <= 0 || count < static_cast<size_t>(period)) return {};
+    return {static_cast<size_t>(period) - 1, count - period + 1};
+}
+
+DataProcessor::OutputLayout DataProcessor::EMALayout(size_t count, int period) {
+    if (period <= 0 || count == 0) return {};
+    return {0, count};
+}
+
+DataProcessor::OutputLayout DataProcessor::ReturnsLayout(size_t count) {
+    if (count < 2) return {};
+    return {1, count - 1};
+}
+
+DataProcessor::OutputLayout DataProcessor::VolatilityLayout(size_t count, int window) {
+    // Window k covers the returns into bars k + 1 .. k + window
+    if (window <= 0 || count < static_cast<size_t>(window) + 1) return {};
+    return {static_cast<size_t>(window), count - window};
+}
+
+DataProcessor::OutputLayout DataProcessor::RSILayout(size_t count, int period) {
+    if (period <= 0 || count < static_cast<size_t>(period) + 1) return {};
+    return {static_cast<size_t>(period) + 1, count - period - 1};
+}
+
+DataProcessor::OutputLayout DataProcessor::MACDLayout(size_t count, int fastPeriod, int slowPeriod,
+                                                      int signalPeriod) {
+    if (fastPeriod <= 0 || slowPeriod <= 0 || count == 0 ||
+        count < static_cast<size_t>(slowPeriod + signalPeriod)) {
+        return {};
+    }
+    return {0, count};
+}
+
+DataProcessor::OutputLayout DataProcessor::BollingerLayout(size_t count, int period) {
+    return SMALayout(count, period);
+}
+
+std::vector<double> DataProcessor::CalculateSMA(const PriceSeries& data, int period) {
+    std::vector<double> sma(SMALayout(data.size(), period).length);
+    CalculateSMA(data.Closes(), period, sma);
     return sma;
 }
 
-std::vector<double> DataProcessor::CalculateEMA(const std::vector<StockData>& data, int period) {
-    std::vector<double> ema;
-    if (data.empty() || period <= 0) {
-        return ema;
+size_t DataProcessor::CalculateSMA(Span<const double> closes, int period, Span<double> out) {
+    OutputLayout layout = SMALayout(closes.size(), period);
+    if (!Fits(out, layout, "SMA")) {
+        return 0;
     }
-    
-    double multiplier = 2.0 / (period + 1.0);
-    double currentEMA = data[0].close;
-    ema.push_back(currentEMA);
-    
-    for (size_t i = 1; i < data.size(); ++i) {
-        currentEMA = (data[i].close - currentEMA) * multiplier + currentEMA;
-        ema.push_back(currentEMA);
+
+    // Neumaier-compensated running sum: each close is added once and removed
+    // once, and the compensation term stops the add/remove error from
+    // drifting over long series
+    double sum = 0.0;
+    double compensation = 0.0;
+    for (int i = 0; i < period; ++i) {
+        CompensatedAdd(sum, compensation, closes[i]);
+    }
+    out[0] = (sum + compensation) / period;
+    for (size_t i = period; i < closes.size(); ++i) {
+        CompensatedAdd(sum, compensation, closes[i]);
+        CompensatedAdd(sum, compensation, -closes[i - period]);
+        out[i - period + 1] = (sum + compensation) / period;
+    }
+    return layout.length;
+}
+
+std::vector<std::vector<double>> DataProcessor::CalculateSMAs(const PriceSeries& data,
+                                                              const std::vector<int>& periods,
+                                                              bool compensated) {
+    std::vector<std::vector<double>> smas(periods.size());
+    size_t count = data.size();
+    const double* closes = data.close.data();
+
+    // prefix[i] (+ low[i]) is the sum of the first i closes; with
+    // compensation the low-order part of each partial sum is kept in `low`
+    std::vector<double> prefix(count + 1, 0.0);
+    std::vector<double> low;
+    if (compensated) {
+        low.assign(count + 1, 0.0);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        double t = prefix[i] + closes[i];
+        if (compensated) {
+            // TwoSum: exact rounding error of the addition
+            double z = t - prefix[i];
+            low[i + 1] = low[i] + ((prefix[i] - (t - z)) + (closes[i] - z));
+        }
+        prefix[i + 1] = t;
+    }
+
+    for (size_t p = 0; p < periods.size(); ++p) {
+        int period = periods[p];
+        if (period <= 0 || count < static_cast<size_t>(period)) {
+            continue;
+        }
+        std::vector<double>& sma = smas[p];
+        sma.resize(count - period + 1);
+        for (size_t k = 0; k < sma.size(); ++k) {
+            double sum = prefix[k + period] - prefix[k];
+            if (compensated) {
+                sum += low[k + period] - low[k];
+            }
+            sma[k] = sum / period;
+        }
     }
+    return smas;
+}
+
+std::vector<double> DataProcessor::CalculateEMA(const PriceSeries& data, int period) {
+    std::vector<double> ema(EMALayout(data.size(), period).length);
+    CalculateEMA(data.Closes(), period, ema);
     return ema;
 }
 
-std::vector<double> DataProcessor::CalculateReturns(const std::vector<StockData>& data) {
-    std::vector<double> returns;
-    if (data.size() < 2) {
-        return returns;
+size_t DataProcessor::CalculateEMA(Span<const double> closes, int period, Span<double> out) {
+    OutputLayout layout = EMALayout(closes.size(), period);
+    if (!Fits(out, layout, "EMA")) {
+        return 0;
     }
     
-    for (size_t i = 1; i < data.size(); ++i) {
-        double ret = (data[i].close - data[i-1].close) / data[i-1].close;
-        returns.push_back(ret);
+    double multiplier = 2.0 / (period + 1.0);
+    double currentEMA = closes[0];
+    out[0] = currentEMA;
+    for (size_t i = 1; i < closes.size(); ++i) {
+        currentEMA = (closes[i] - currentEMA) * multiplier + currentEMA;
+        out[i] = currentEMA;
     }
+    return layout.length;
+}
+
+std::vector<double> DataProcessor::CalculateReturns(const PriceSeries& data) {
+    std::vector<double> returns(ReturnsLayout(data.size()).length);
+    CalculateReturns(data.Closes(), returns);
     return returns;
 }
 
-std::vector<double> DataProcessor::CalculateVolatility(const std::vector<StockData>& data, int window) {
-    std::vector<double> volatility;
-    auto returns = CalculateReturns(data);
-    
-    if (returns.size() < static_cast<size_t>(window)) {
-        return volatility;
+Panel DataProcessor::CalculateReturns(const Panel& prices) {
+    if (prices.StorageLayout() != Panel::Layout::ColumnMajor) {
+        return CalculateReturns(prices.WithLayout(Panel::Layout::ColumnMajor));
+    }
+    if (prices.Dates() < 2) {
+        return Panel(prices.TickerNames(), {});
+    }
+    
+    // Return d is from date d to date d + 1 and is dated d + 1
+    const std::vector<int32_t>& axis = prices.DateAxis();
+    Panel returns(prices.TickerNames(), std::vector<int32_t>(axis.begin() + 1, axis.end()));
+    for (size_t t = 0; t < prices.Tickers(); ++t) {
+        CalculateReturns(prices.Column(t).Contiguous(), returns.Column(t).Contiguous());
+        for (size_t d = 0; d < returns.Dates(); ++d) {
+            if (prices.IsValid(d, t) && prices.IsValid(d + 1, t)) {
+                returns.SetValid(d, t);
+            }
+        }
     }
-    
-    for (size_t i = window - 1; i < returns.size(); ++i) {
-        std::vector<double> windowReturns(returns.begin() + i - window + 1, returns.begin() + i + 1);
-        double stdDev = CalculateStdDev(windowReturns);
-        volatility.push_back(stdDev * std::sqrt(252.0)); // Annualized volatility
+    return returns;
+}
+
+Panel DataProcessor::CalculateAlignedReturns(const std::vector<PriceSeries>& multipleStocks,
+                                             const std::vector<std::string>& tickers) {
+    PanelBuilder builder(JoinPolicy::Inner);
+    for (size_t i = 0; i < multipleStocks.size(); ++i) {
+        builder.Add(multipleStocks[i], i < tickers.size() ? tickers[i] : std::string());
+    }
+    return CalculateReturns(builder.Build());
+}
+
+size_t DataProcessor::CalculateReturns(Span<const double> closes, Span<double> out) {
+    OutputLayout layout = ReturnsLayout(closes.size());
+    if (!Fits(out, layout, "returns")) {
+        return 0;
     }
+    SimdKernels::Returns(closes.data(), closes.size(), out.data());
+    return layout.length;
+}
+
+std::vector<double> DataProcessor::CalculateVolatility(const PriceSeries& data, int window) {
+    std::vector<double> volatility(VolatilityLayout(data.size(), window).length);
+    if (volatility.empty()) {
+        return volatility;
+    }
+    // With a vector to return anyway, the returns are worth materializing:
+    // each is then divided out once instead of twice
+    auto returns = CalculateReturns(data);
+    CalculateVolatilityFromReturns(returns, window, volatility);
     return volatility;
 }
 
-std::vector<double> DataProcessor::CalculateRollingVolatility(const std::vector<StockData>& data, int window) {
+size_t DataProcessor::CalculateVolatility(Span<const double> closes, int window, Span<double> out) {
+    OutputLayout layout = VolatilityLayout(closes.size(), window);
+    if (!Fits(out, layout, "volatility")) {
+        return 0;
+    }
+    // Returns are derived from the closes as the window needs them, so
+    // nothing is allocated
+    const double* prices = closes.data();
+    RollingVolatility([prices](size_t i) { return (prices[i + 1] - prices[i]) / prices[i]; },
+                      closes.size() - 1, window, out.data());
+    return layout.length;
+}
+
+size_t DataProcessor::CalculateVolatilityFromReturns(Span<const double> returns, int window, Span<double> out) {
+    OutputLayout layout = VolatilityLayout(returns.size() + 1, window);
+    if (!Fits(out, layout, "volatility")) {
+        return 0;
+    }
+    const double* values = returns.data();
+    RollingVolatility([values](size_t i) { return values[i]; }, returns.size(), window, out.data());
+    return layout.length;
+}
+
+std::vector<double> DataProcessor::CalculateRollingVolatility(const PriceSeries& data, int window) {
     return CalculateVolatility(data, window);
 }
 
 double DataProcessor::CalculateMean(const std::vector<double>& values) {
+    return CalculateMean(Span<const double>(values));
+}
+
+double DataProcessor::CalculateMean(Span<const double> values) {
     if (values.empty()) return 0.0;
-    double sum = std::accumulate(values.begin(), values.end(), 0.0);
-    return sum / values.size();
+    return SimdKernels::Sum(values.data(), values.size()) / values.size();
 }
 
 double DataProcessor::CalculateVariance(const std::vector<double>& values) {
+    return CalculateVariance(Span<const double>(values));
+}
+
+double DataProcessor::CalculateVariance(Span<const double> values) {
     if (values.empty()) return 0.0;
     double mean = CalculateMean(values);
-    double variance = 0.0;
-    for (double val : values) {
-        variance += (val - mean) * (val - mean);
-    }
-    return variance / values.size();
+    return SimdKernels::SumSquaredDeviations(values.data(), values.size(), mean) / values.size();
 }
 
 double DataProcessor::CalculateStdDev(const std::vector<double>& values) {
     return std::sqrt(CalculateVariance(values));
 }
 
+double DataProcessor::CalculateStdDev(Span<const double> values) {
+    return std::sqrt(CalculateVariance(values));
+}
+
 double DataProcessor::CalculateMax(const std::vector<double>& values) {
+    return CalculateMax(Span<const double>(values));
+}
+
+double DataProcessor::CalculateMax(Span<const double> values) {
     if (values.empty()) return 0.0;
     return *std::max_element(values.begin(), values.end());
 }
 
 double DataProcessor::CalculateMin(const std::vector<double>& values) {
+    return CalculateMin(Span<const double>(values));
+}
+
+double DataProcessor::CalculateMin(Span<const double> values) {
     if (values.empty()) return 0.0;
     return *std::min_element(values.begin(), values.end());
 }
@@ -111,8 +347,11 @@ double DataProcessor::CalculateMedian(const std::vector<double>& values) {
         return sorted[n/2];
     }
 }
-
 double DataProcessor::CalculateCorrelation(const std::vector<double>& x, const std::vector<double>& y) {
+    return CalculateCorrelation(Span<const double>(x), Span<const double>(y));
+}
+
+double DataProcessor::CalculateCorrelation(Span<const double> x, Span<const double> y) {
     if (x.size() != y.size() || x.size() < 2) return 0.0;
     
     double meanX = CalculateMean(x);
@@ -121,14 +360,8 @@ double DataProcessor::CalculateCorrelation(const std::vector<double>& x, const s
     double numerator = 0.0;
     double sumXSq = 0.0;
     double sumYSq = 0.0;
-    
-    for (size_t i = 0; i < x.size(); ++i) {
-        double dx = x[i] - meanX;
-        double dy = y[i] - meanY;
-        numerator += dx * dy;
-        sumXSq += dx * dx;
-        sumYSq += dy * dy;
-    }
+    SimdKernels::SumDeviationProducts(x.data(), y.data(), x.size(), meanX, meanY,
+                                      numerator, sumXSq, sumYSq);
     
     double denominator = std::sqrt(sumXSq * sumYSq);
     if (denominator == 0.0) return 0.0;
@@ -136,114 +369,393 @@ double DataProcessor::CalculateCorrelation(const std::vector<double>& x, const s
     return numerator / denominator;
 }
 
-std::vector<double> DataProcessor::CalculateRSI(const std::vector<StockData>& data, int period) {
-    std::vector<double> rsi;
-    if (data.size() < static_cast<size_t>(period + 1)) {
-        return rsi;
-    }
-    
-    std::vector<double> gains;
-    std::vector<double> losses;
-    
-    // Calculate price changes
-    for (size_t i = 1; i < data.size(); ++i) {
-        double change = data[i].close - data[i-1].close;
-        gains.push_back(change > 0 ? change : 0.0);
-        losses.push_back(change < 0 ? -change : 0.0);
+std::vector<double> DataProcessor::CalculateRSI(const PriceSeries& data, int period) {
+    std::vector<double> rsi(RSILayout(data.size(), period).length);
+    CalculateRSI(data.Closes(), period, rsi);
+    return rsi;
+}
+
+size_t DataProcessor::CalculateRSI(Span<const double> closes, int period, Span<double> out) {
+    OutputLayout layout = RSILayout(closes.size(), period);
+    if (!Fits(out, layout, "RSI")) {
+        return 0;
     }
-    
-    // Calculate initial average gain and loss
-    double avgGain = CalculateMean(std::vector<double>(gains.begin(), gains.begin() + period));
-    double avgLoss = CalculateMean(std::vector<double>(losses.begin(), losses.begin() + period));
+
+    // Gain and loss of price change i (from close i to close i + 1)
+    const double* prices = closes.data();
+    auto gainAt = [prices](size_t i) {
+        double change = prices[i + 1] - prices[i];
+        return change > 0 ? change : 0.0;
+    };
+    auto lossAt = [prices](size_t i) {
+        double change = prices[i + 1] - prices[i];
+        return change < 0 ? -change : 0.0;
+    };
+    
+    // Calculate initial average gain and loss (summed in order, like the
+    // streaming and pipeline versions)
+    double gainSum = 0.0;
+    double lossSum = 0.0;
+    for (int i = 0; i < period; ++i) {
+        gainSum += gainAt(i);
+        lossSum += lossAt(i);
+    }
+    double avgGain = gainSum / period;
+    double avgLoss = lossSum / period;
     
     // Calculate RSI for remaining periods
-    for (size_t i = period; i < gains.size(); ++i) {
+    const size_t changes = closes.size() - 1;
+    for (size_t i = period; i < changes; ++i) {
         // Use Wilder's smoothing method
-        avgGain = (avgGain * (period - 1) + gains[i]) / period;
-        avgLoss = (avgLoss * (period - 1) + losses[i]) / period;
+        avgGain = (avgGain * (period - 1) + gainAt(i)) / period;
+        avgLoss = (avgLoss * (period - 1) + lossAt(i)) / period;
         
         if (avgLoss == 0.0) {
-            rsi.push_back(100.0);
+            out[i - period] = 100.0;
         } else {
             double rs = avgGain / avgLoss;
-            rsi.push_back(100.0 - (100.0 / (1.0 + rs)));
+            out[i - period] = 100.0 - (100.0 / (1.0 + rs));
         }
     }
-    
-    return rsi;
+    return layout.length;
 }
 
-DataProcessor::MACDResult DataProcessor::CalculateMACD(const std::vector<StockData>& data,
+DataProcessor::MACDResult DataProcessor::CalculateMACD(const PriceSeries& data,
                                                        int fastPeriod, int slowPeriod, int signalPeriod) {
     MACDResult result;
-    
-    if (data.size() < static_cast<size_t>(slowPeriod + signalPeriod)) {
-        return result;
-    }
-    
-    // Calculate EMAs
-    auto fastEMA = CalculateEMA(data, fastPeriod);
-    auto slowEMA = CalculateEMA(data, slowPeriod);
-    
-    // Calculate MACD line (fast EMA - slow EMA)
-    size_t minSize = std::min(fastEMA.size(), slowEMA.size());
-    for (size_t i = 0; i < minSize; ++i) {
-        result.macd.push_back(fastEMA[i] - slowEMA[i]);
-    }
-    
-    // Calculate Signal line (EMA of MACD)
-    if (result.macd.size() >= static_cast<size_t>(signalPeriod)) {
-        // Convert MACD to StockData format for EMA calculation
-        std::vector<StockData> macdData;
-        size_t offset = data.size() - result.macd.size();
-        for (size_t i = 0; i < result.macd.size(); ++i) {
-            StockData sd = data[offset + i];
-            sd.close = result.macd[i];
-            macdData.push_back(sd);
-        }
-        result.signal = CalculateEMA(macdData, signalPeriod);
+    size_t length = MACDLayout(data.size(), fastPeriod, slowPeriod, signalPeriod).length;
+    result.macd.resize(length);
+    if (signalPeriod > 0) {
+        result.signal.resize(length);
+        result.histogram.resize(length);
+    }
+    CalculateMACD(data.Closes(), fastPeriod, slowPeriod, signalPeriod,
+                  result.macd, result.signal, result.histogram);
+    return result;
+}
+
+size_t DataProcessor::CalculateMACD(Span<const double> closes, int fastPeriod, int slowPeriod, int signalPeriod,
+                                    Span<double> macd, Span<double> signal, Span<double> histogram) {
+    OutputLayout layout = MACDLayout(closes.size(), fastPeriod, slowPeriod, signalPeriod);
+    if (!Fits(macd, layout, "MACD") ||
+        (signalPeriod > 0 && (!Fits(signal, layout, "MACD signal") || !Fits(histogram, layout, "MACD histogram")))) {
+        return 0;
+    }
+    
+    // MACD line (fast EMA - slow EMA), both EMAs advanced together
+    double fastMultiplier = 2.0 / (fastPeriod + 1.0);
+    double slowMultiplier = 2.0 / (slowPeriod + 1.0);
+    double fastEMA = closes[0];
+    double slowEMA = closes[0];
+    macd[0] = fastEMA - slowEMA;
+    for (size_t i = 1; i < closes.size(); ++i) {
+        fastEMA = (closes[i] - fastEMA) * fastMultiplier + fastEMA;
+        slowEMA = (closes[i] - slowEMA) * slowMultiplier + slowEMA;
+        macd[i] = fastEMA - slowEMA;
+    }
+    
+    // Signal line is an EMA over the MACD values themselves
+    if (signalPeriod > 0) {
+        Span<const double> line = macd.first(layout.length);
+        CalculateEMA(line, signalPeriod, signal);
         
         // Calculate Histogram (MACD - Signal)
-        size_t signalOffset = result.macd.size() - result.signal.size();
-        for (size_t i = 0; i < result.signal.size(); ++i) {
-            result.histogram.push_back(result.macd[signalOffset + i] - result.signal[i]);
+        for (size_t i = 0; i < layout.length; ++i) {
+            histogram[i] = macd[i] - signal[i];
         }
     }
-    
-    return result;
+    return layout.length;
 }
 
 DataProcessor::BollingerBands DataProcessor::CalculateBollingerBands(
-    const std::vector<StockData>& data, int period, double stdDevMultiplier) {
+    const PriceSeries& data, int period, double stdDevMultiplier) {
     
     BollingerBands bands;
-    
-    if (data.size() < static_cast<size_t>(period)) {
-        return bands;
+    size_t length = BollingerLayout(data.size(), period).length;
+    bands.upper.resize(length);
+    bands.middle.resize(length);
+    bands.lower.resize(length);
+    CalculateBollingerBands(data.Closes(), period, stdDevMultiplier, bands.upper, bands.middle, bands.lower);
+    return bands;
+}
+
+size_t DataProcessor::CalculateBollingerBands(Span<const double> closes, int period, double stdDevMultiplier,
+                                              Span<double> upper, Span<double> middle, Span<double> lower) {
+    if (CalculateSMA(closes, period, middle) == 0) {
+        return 0;
     }
-    
-    auto sma = CalculateSMA(data, period);
-    bands.middle = sma;
-    
-    // Calculate standard deviation for each period
-    for (size_t i = period - 1; i < data.size(); ++i) {
-        std::vector<double> window;
-        for (int j = 0; j < period; ++j) {
-            window.push_back(data[i - j].close);
+    return CalculateBollingerEnvelope(closes, middle, period, stdDevMultiplier, upper, lower);
+}
+
+size_t DataProcessor::CalculateBollingerEnvelope(Span<const double> closes, Span<const double> middle,
+                                                 int period, double stdDevMultiplier,
+                                                 Span<double> upper, Span<double> lower) {
+    OutputLayout layout = BollingerLayout(closes.size(), period);
+    if (middle.size() < layout.length) {
+        std::cerr << "Error: Bollinger middle band has " << middle.size() << " values, "
+                  << layout.length << " needed\n";
+        return 0;
+    }
+    if (!Fits(upper, layout, "Bollinger upper") || !Fits(lower, layout, "Bollinger lower")) {
+        return 0;
+    }
+    
+    // Standard deviation of each window, updated as the window slides
+    RollingStats stats;
+    stats.Rebuild(closes.data(), period);
+    for (size_t smaIdx = 0; smaIdx < layout.length; ++smaIdx) {
+        if (smaIdx > 0) {
+            stats.Slide(closes[smaIdx + period - 1], closes[smaIdx - 1]);
+            if (stats.NeedsRebuild()) {
+                stats.Rebuild(closes.data() + smaIdx, period);
+            }
         }
-        double stdDev = CalculateStdDev(window);
-        size_t smaIdx = i - (period - 1);
-        double middle = bands.middle[smaIdx];
-        bands.upper.push_back(middle + (stdDevMultiplier * stdDev));
-        bands.lower.push_back(middle - (stdDevMultiplier * stdDev));
+        double offset = stdDevMultiplier * stats.StdDev();
+        upper[smaIdx] = middle[smaIdx] + offset;
+        lower[smaIdx] = middle[smaIdx] - offset;
     }
-    
-    return bands;
+    return layout.length;
+}
+
+DataProcessor::IndicatorResults DataProcessor::RunIndicatorPipeline(const PriceSeries& data,
+                                                                   const IndicatorSet& indicators) {
+    IndicatorResults results;
+    results.sma.resize(indicators.smaPeriods.size());
+    results.ema.resize(indicators.emaPeriods.size());
+
+    const size_t count = data.size();
+    const double* closes = data.close.data();
+
+    // Work out what can be produced, with the same length checks as the
+    // single-indicator functions, and give each distinct period one state
+    const int volWindow = indicators.volatilityWindow;
+    const int rsiPeriod = indicators.rsiPeriod;
+    const int bollingerPeriod = indicators.bollingerPeriod;
+    bool wantBollinger = bollingerPeriod > 0 && count >= static_cast<size_t>(bollingerPeriod);
+    bool wantMACD = indicators.macd && indicators.macdFast > 0 && indicators.macdSlow > 0 &&
+                    count >= static_cast<size_t>(indicators.macdSlow + indicators.macdSignal);
+    bool wantSignal = wantMACD && indicators.macdSignal > 0;
+    bool wantVolatility = volWindow > 0 && count >= static_cast<size_t>(volWindow) + 1;
+    bool wantRSI = rsiPeriod > 0 && count >= static_cast<size_t>(rsiPeriod) + 1;
+    bool wantReturns = (indicators.returns || wantVolatility) && count >= 2;
+
+    std::vector<AverageState> smas;
+    std::vector<AverageState> emas;
+    std::vector<int> smaSlot(indicators.smaPeriods.size(), -1);
+    std::vector<int> emaSlot(indicators.emaPeriods.size(), -1);
+    for (size_t k = 0; k < indicators.smaPeriods.size(); ++k) {
+        int period = indicators.smaPeriods[k];
+        if (period > 0 && count >= static_cast<size_t>(period)) {
+            smaSlot[k] = static_cast<int>(StateFor(smas, period));
+            ++smas[smaSlot[k]].uses;
+        }
+    }
+    for (size_t k = 0; k < indicators.emaPeriods.size(); ++k) {
+        int period = indicators.emaPeriods[k];
+        if (period > 0 && count > 0) {
+            emaSlot[k] = static_cast<int>(StateFor(emas, period));
+            ++emas[emaSlot[k]].uses;
+        }
+    }
+    size_t bollingerSMA = 0;
+    if (wantBollinger) {
+        bollingerSMA = StateFor(smas, bollingerPeriod);
+        ++smas[bollingerSMA].uses;
+    }
+    size_t fastEMA = wantMACD ? StateFor(emas, indicators.macdFast) : 0;
+    size_t slowEMA = wantMACD ? StateFor(emas, indicators.macdSlow) : 0;
+
+    // Every output is sized up front and written by index
+    for (auto& sma : smas) {
+        sma.output.resize(count - sma.period + 1);
+    }
+    for (auto& ema : emas) {
+        ema.multiplier = 2.0 / (ema.period + 1.0);
+        ema.output.resize(count);
+    }
+    std::vector<double> returnsScratch;
+    std::vector<double>& returns = indicators.returns ? results.returns : returnsScratch;
+    if (wantReturns) returns.resize(count - 1);
+    if (wantVolatility) results.volatility.resize(count - volWindow);
+    if (wantRSI) results.rsi.resize(count - 1 - rsiPeriod);
+    if (wantMACD) results.macd.macd.resize(count);
+    if (wantSignal) {
+        results.macd.signal.resize(count);
+        results.macd.histogram.resize(count);
+    }
+    if (wantBollinger) {
+        results.bollinger.upper.resize(count - bollingerPeriod + 1);
+        results.bollinger.lower.resize(count - bollingerPeriod + 1);
+    }
+
+    const double signalMultiplier = wantSignal ? 2.0 / (indicators.macdSignal + 1.0) : 0.0;
+    const double annualize = std::sqrt(252.0);
+    RollingStats closeStats;
+    RollingStats returnStats;
+    double signal = 0.0;
+    double gainSum = 0.0, lossSum = 0.0;
+    double avgGain = 0.0, avgLoss = 0.0;
+
+    // One pass over the closes in cache-sized blocks. Each indicator sweeps
+    // the block with its state in locals; the block (and the outputs that
+    // later indicators read back, such as the EMAs behind MACD) is still in
+    // L1, so the series is streamed from memory once.
+    for (size_t begin = 0; begin < count; begin += PipelineBlock) {
+        const size_t end = std::min(count, begin + PipelineBlock);
+
+        for (auto& sma : smas) {
+            const size_t period = static_cast<size_t>(sma.period);
+            double sum = sma.sum;
+            double compensation = sma.compensation;
+            double* out = sma.output.data();
+            for (size_t i = begin; i < end; ++i) {
+                CompensatedAdd(sum, compensation, closes[i]);
+                if (i >= period) {
+                    CompensatedAdd(sum, compensation, -closes[i - period]);
+                }
+                if (i + 1 >= period) {
+                    out[i + 1 - period] = (sum + compensation) / sma.period;
+                }
+            }
+            sma.sum = sum;
+            sma.compensation = compensation;
+        }
+
+        for (auto& ema : emas) {
+            double value = begin == 0 ? closes[0] : ema.value;
+            const double multiplier = ema.multiplier;
+            double* out = ema.output.data();
+            if (begin == 0) {
+                out[0] = value;
+            }
+            for (size_t i = std::max<size_t>(begin, 1); i < end; ++i) {
+                value = (closes[i] - value) * multiplier + value;
+                out[i] = value;
+            }
+            ema.value = value;
+        }
+
+        if (wantMACD) {
+            const double* fast = emas[fastEMA].output.data();
+            const double* slow = emas[slowEMA].output.data();
+            double* macd = results.macd.macd.data();
+            for (size_t i = begin; i < end; ++i) {
+                macd[i] = fast[i] - slow[i];
+            }
+            if (wantSignal) {
+                double* signalOut = results.macd.signal.data();
+                double* histogram = results.macd.histogram.data();
+                for (size_t i = begin; i < end; ++i) {
+                    signal = i == 0 ? macd[i] : (macd[i] - signal) * signalMultiplier + signal;
+                    signalOut[i] = signal;
+                    histogram[i] = macd[i] - signal;
+                }
+            }
+        }
+
+        if (wantBollinger) {
+            const size_t period = static_cast<size_t>(bollingerPeriod);
+            const double* middle = smas[bollingerSMA].output.data();
+            double* upper = results.bollinger.upper.data();
+            double* lower = results.bollinger.lower.data();
+            RollingStats stats = closeStats;
+            for (size_t i = std::max(begin, period - 1); i < end; ++i) {
+                size_t first = i + 1 - period;
+                if (first == 0) {
+                    stats.Rebuild(closes, period);
+                } else {
+                    stats.Slide(closes[i], closes[first - 1]);
+                    if (stats.NeedsRebuild()) {
+                        stats.Rebuild(closes + first, period);
+                    }
+                }
+                double offset = indicators.bollingerStd * stats.StdDev();
+                upper[first] = middle[first] + offset;
+                lower[first] = middle[first] - offset;
+            }
+            closeStats = stats;
+        }
+
+        // Indicators on price changes start at the second bar; change j is
+        // closes[j + 1] against closes[j]
+        const size_t changeBegin = begin == 0 ? 0 : begin - 1;
+        const size_t changeEnd = end - 1;
+
+        if (wantReturns) {
+            double* out = returns.data();
+            for (size_t j = changeBegin; j < changeEnd; ++j) {
+                out[j] = (closes[j + 1] - closes[j]) / closes[j];
+            }
+        }
+
+        if (wantVolatility) {
+            const size_t window = static_cast<size_t>(volWindow);
+            double* out = results.volatility.data();
+            RollingStats stats = returnStats;
+            for (size_t j = std::max(changeBegin, window - 1); j < changeEnd; ++j) {
+                if (j + 1 == window) {
+                    stats.Rebuild(returns.data(), window);
+                } else {
+                    stats.Slide(returns[j], returns[j - window]);
+                    if (stats.NeedsRebuild()) {
+                        stats.Rebuild(&returns[j + 1 - window], window);
+                    }
+                }
+                out[j + 1 - window] = stats.StdDev() * annualize;
+            }
+            returnStats = stats;
+        }
+
+        if (wantRSI) {
+            const size_t period = static_cast<size_t>(rsiPeriod);
+            double* out = results.rsi.data();
+            for (size_t j = changeBegin; j < changeEnd; ++j) {
+                double change = closes[j + 1] - closes[j];
+                double gain = change > 0 ? change : 0.0;
+                double loss = change < 0 ? -change : 0.0;
+                if (j < period) {
+                    gainSum += gain;
+                    lossSum += loss;
+                    if (j + 1 == period) {
+                        avgGain = gainSum / rsiPeriod;
+                        avgLoss = lossSum / rsiPeriod;
+                    }
+                    continue;
+                }
+                // Wilder's smoothing, as in CalculateRSI
+                avgGain = (avgGain * (rsiPeriod - 1) + gain) / rsiPeriod;
+                avgLoss = (avgLoss * (rsiPeriod - 1) + loss) / rsiPeriod;
+                out[j - period] = avgLoss == 0.0 ? 100.0 : 100.0 - (100.0 / (1.0 + avgGain / avgLoss));
+            }
+        }
+    }
+
+    for (size_t k = 0; k < smaSlot.size(); ++k) {
+        if (smaSlot[k] >= 0) {
+            results.sma[k] = TakeOutput(smas[smaSlot[k]]);
+        }
+    }
+    for (size_t k = 0; k < emaSlot.size(); ++k) {
+        if (emaSlot[k] >= 0) {
+            results.ema[k] = TakeOutput(emas[emaSlot[k]]);
+        }
+    }
+    if (wantBollinger) {
+        results.bollinger.middle = TakeOutput(smas[bollingerSMA]);
+    }
+    return results;
 }
 
 DataProcessor::PCAResult DataProcessor::PerformPCA(
     const std::vector<std::vector<StockData>>& multipleStocks,
-    const std::vector<std::string>& tickers, int topN) {
+    const std::vector<std::string>& tickers, int topN, PCAMethod method) {
+    std::vector<PriceSeries> series(multipleStocks.begin(), multipleStocks.end());
+    return PerformPCA(series, tickers, topN, method);
+}
+
+DataProcessor::PCAResult DataProcessor::PerformPCA(
+    const std::vector<PriceSeries>& multipleStocks,
+    const std::vector<std::string>& tickers, int topN, PCAMethod method) {
     
     PCAResult result;
     result.success = false;
@@ -253,57 +765,96 @@ DataProcessor::PCAResult DataProcessor::PerformPCA(
         return result;
     }
     
-    // Convert stock data to returns matrix
-    std::vector<std::vector<double>> returnsMatrix;
-    size_t minSize = SIZE_MAX;
-    
-    for (const auto& stock : multipleStocks) {
-        auto returns = CalculateReturns(stock);
-        returnsMatrix.push_back(returns);
-        minSize = std::min(minSize, returns.size());
+    return PerformPCA(CalculateAlignedReturns(multipleStocks, tickers), topN, method);
+}
+
+DataProcessor::PCAResult DataProcessor::PerformPCA(const Panel& returns, int topN, PCAMethod method) {
+    if (returns.StorageLayout() != Panel::Layout::ColumnMajor) {
+        return PerformPCA(returns.WithLayout(Panel::Layout::ColumnMajor), topN, method);
     }
     
-    if (minSize < 2 || returnsMatrix.size() < 2) {
+    PCAResult result;
+    result.success = false;
+    
+    size_t stocks = returns.Tickers();
+    size_t samples = returns.Dates();
+    
+    if (samples < 2 || stocks < 2) {
         std::cerr << "Error: Insufficient data for PCA\n";
         return result;
     }
-    
-    // Align all returns to same length
-    for (auto& returns : returnsMatrix) {
-        if (returns.size() > minSize) {
-            returns.erase(returns.begin(), returns.begin() + (returns.size() - minSize));
-        }
+    if (returns.ValidCount() != stocks * samples) {
+        std::cerr << "Error: PCA needs returns without missing values\n";
+        return result;
     }
     
-    // Compute covariance matrix
-    auto covMatrix = ComputeCovarianceMatrix(returnsMatrix);
+    size_t components = static_cast<size_t>(std::max(0, std::min(topN, static_cast<int>(stocks))));
+    if (method == PCAMethod::Auto) {
+        bool large = stocks >= RandomizedPCAMinStocks &&
+                     components + RandomizedPCAOptions().oversampling <= stocks / 4;
+        method = large ? PCAMethod::Randomized : PCAMethod::Exact;
+    }
     
-    if (covMatrix.empty()) {
-        std::cerr << "Error: Failed to compute covariance matrix\n";
+    SymmetricEigenResult eigen;
+    double totalVariance = 0.0;
+    if (method == PCAMethod::Randomized) {
+        eigen = RandomizedPCA(returns, components);
+        // Total variance is the covariance trace, i.e. the sum of the
+        // stocks' own variances, so no other eigenvalue is needed
+        for (size_t i = 0; i < stocks; ++i) {
+            Span<const double> column = returns.Column(i).Contiguous();
+            double mean = CalculateMean(column);
+            totalVariance += SimdKernels::SumSquaredDeviations(column.data(), samples, mean) / (samples - 1);
+        }
+    } else {
+        auto matrices = CovarianceEngine().Compute(returns, false);
+        if (!matrices.success) {
+            std::cerr << "Error: Failed to compute covariance matrix\n";
+            return result;
+        }
+        eigen = SymmetricEigen(matrices.covariance);
+        for (double value : eigen.values) {
+            totalVariance += std::max(0.0, value);
+        }
+    }
+    if (!eigen.success) {
+        std::cerr << "Error: PCA eigen-decomposition failed\n";
         return result;
     }
     
-    // Simple PCA: Find principal components by variance
-    // For full PCA, Eigen library would be better, but this gives a working implementation
-    std::vector<double> variances;
-    for (size_t i = 0; i < covMatrix.size(); ++i) {
-        variances.push_back(covMatrix[i][i]); // Diagonal elements are variances
+    // Kept components and how much of the variance each explains
+    for (size_t k = 0; k < components; ++k) {
+        double variance = std::max(0.0, eigen.values[k]);
+        result.explainedVariance.push_back(variance);
+        result.explainedVarianceRatio.push_back(totalVariance > 0.0 ? variance / totalVariance : 0.0);
+        result.principalComponents.push_back(eigen.vectors[k]);
     }
     
-    // Get top N stocks by variance (simplified approach)
-    std::vector<std::pair<double, size_t>> indexedVariances;
-    for (size_t i = 0; i < variances.size(); ++i) {
-        indexedVariances.push_back({variances[i], i});
+    // Influence: each stock's part of the variance the kept components carry
+    std::vector<double> influence(stocks, 0.0);
+    double keptVariance = 0.0;
+    for (size_t k = 0; k < components; ++k) {
+        keptVariance += result.explainedVariance[k];
+        for (size_t i = 0; i < stocks; ++i) {
+            double loading = eigen.vectors[k][i];
+            influence[i] += result.explainedVariance[k] * loading * loading;
+        }
+    }
+    if (keptVariance > 0.0) {
+        for (double& score : influence) {
+            score /= keptVariance;
+        }
     }
     
-    std::sort(indexedVariances.rbegin(), indexedVariances.rend());
-    
-    int n = std::min(topN, static_cast<int>(indexedVariances.size()));
-    for (int i = 0; i < n; ++i) {
-        size_t idx = indexedVariances[i].second;
-        result.influentialStocks.push_back(tickers[idx]);
-        result.explainedVariance.push_back(indexedVariances[i].first);
+    std::vector<size_t> ranked(stocks);
+    std::iota(ranked.begin(), ranked.end(), 0);
+    std::stable_sort(ranked.begin(), ranked.end(),
+                     [&influence](size_t lhs, size_t rhs) { return influence[lhs] > influence[rhs]; });
+    for (size_t i = 0; i < components; ++i) {
+        result.influentialStocks.push_back(returns.TickerNames()[ranked[i]]);
+        result.influence.push_back(influence[ranked[i]]);
     }
+    result.eigenvalues = std::move(eigen.values);
     
     result.success = true;
     return result;
@@ -316,71 +867,57 @@ std::vector<std::vector<double>> DataProcessor::ComputeCovarianceMatrix(
         return {};
     }
     
-    size_t n = returnsMatrix.size();
-    size_t m = returnsMatrix[0].size();
-    
-    // Verify all rows have same length
-    for (const auto& row : returnsMatrix) {
-        if (row.size() != m) {
-            std::cerr << "Error: Inconsistent returns matrix dimensions\n";
-            return {};
-        }
+    return CovarianceEngine().Compute(returnsMatrix, false).covariance;
+}
+
+std::vector<std::vector<double>> DataProcessor::CalculateCorrelationMatrix(
+    const std::vector<std::vector<double>>& series) {
+    return CovarianceEngine().Compute(series).correlation;
+}
+
+std::vector<std::vector<double>> DataProcessor::CalculateCorrelationMatrix(const Panel& series) {
+    return CovarianceEngine().Compute(series).correlation;
+}
+
+Panel DataProcessor::CalculateCrossSectionalRanks(const Panel& values) {
+    if (values.StorageLayout() != Panel::Layout::RowMajor) {
+        return CalculateCrossSectionalRanks(values.WithLayout(Panel::Layout::RowMajor));
     }
     
-    std::vector<std::vector<double>> covMatrix(n, std::vector<double>(n, 0.0));
-    
-    // Calculate means for each stock
-    std::vector<double> means(n);
-    for (size_t i = 0; i < n; ++i) {
-        means[i] = CalculateMean(returnsMatrix[i]);
-    }
+    Panel ranks(values.TickerNames(), values.DateAxis(), Panel::Layout::RowMajor);
     
-    // Compute covariance matrix
-    for (size_t i = 0; i < n; ++i) {
-        for (size_t j = 0; j < n; ++j) {
-            double sum = 0.0;
-            for (size_t k = 0; k < m; ++k) {
-                sum += (returnsMatrix[i][k] - means[i]) * (returnsMatrix[j][k] - means[j]);
+    std::vector<std::pair<double, size_t>> present;  // value, ticker
+    for (size_t d = 0; d < values.Dates(); ++d) {
+        Span<const double> row = values.Row(d).Contiguous();
+        present.clear();
+        for (size_t t = 0; t < row.size(); ++t) {
+            // NaN or inf (e.g. a return off a zero price) has no rank
+            if (values.IsValid(d, t) && std::isfinite(row[t])) {
+                present.push_back({row[t], t});
             }
-            covMatrix[i][j] = sum / (m - 1); // Sample covariance
+        }
+        std::sort(present.begin(), present.end());
+        
+        // Ties share the mean of the ranks they span
+        for (size_t first = 0; first < present.size();) {
+            size_t last = first;
+            while (last + 1 < present.size() && present[last + 1].first == present[first].first) {
+                ++last;
+            }
+            double rank = present.size() > 1 ? (first + last) / 2.0 / (present.size() - 1) : 0.5;
+            for (size_t i = first; i <= last; ++i) {
+                ranks.Set(d, present[i].second, rank);
+            }
+            first = last + 1;
         }
     }
-    
-    return covMatrix;
+    return ranks;
 }
 
 std::vector<double> DataProcessor::ComputeEigenvalues(const std::vector<std::vector<double>>& matrix) {
-    // Simplified eigenvalue computation for 2x2 matrices
-    // For larger matrices, Eigen library should be used
-    if (matrix.size() == 2 && matrix[0].size() == 2) {
-        double a = matrix[0][0];
-        double b = matrix[0][1];
-        double c = matrix[1][0];
-        double d = matrix[1][1];
-        
-        double trace = a + d;
-        double det = a * d - b * c;
-        
-        double discriminant = trace * trace - 4 * det;
-        if (discriminant < 0) {
-            return {};
-        }
-        
-        double sqrtDisc = std::sqrt(discriminant);
-        return {(trace + sqrtDisc) / 2.0, (trace - sqrtDisc) / 2.0};
-    }
-    
-    // For larger matrices, return diagonal as approximation
-    std::vector<double> eigenvalues;
-    for (size_t i = 0; i < matrix.size() && i < matrix[i].size(); ++i) {
-        eigenvalues.push_back(matrix[i][i]);
-    }
-    return eigenvalues;
+    return SymmetricEigen(matrix).values;
 }
 
 std::vector<std::vector<double>> DataProcessor::ComputeEigenvectors(const std::vector<std::vector<double>>& matrix) {
-    // Placeholder - full implementation requires Eigen library
-    std::vector<std::vector<double>> eigenvectors;
-    return eigenvectors;
+    return SymmetricEigen(matrix).vectors;
 }
-
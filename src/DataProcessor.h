@@ -1,29 +1,49 @@
 #pragma once
 #include "StockData.h"
+#include "PriceSeries.h"
+#include "Panel.h"
+#include "Span.h"
 #include <vector>
 #include <string>
 
 class DataProcessor {
 public:
     // Moving Averages
-    std::vector<double> CalculateSMA(const std::vector<StockData>& data, int period);
-    std::vector<double> CalculateEMA(const std::vector<StockData>& data, int period);
+    // Rolling-sum SMA, O(n) in the series length whatever the period;
+    // element k is the mean of closes [k, k + period)
+    std::vector<double> CalculateSMA(const PriceSeries& data, int period);
+    // One SMA per entry of `periods` (same layout as CalculateSMA), all taken
+    // from a single prefix-sum pass over the closes. `compensated` keeps the
+    // prefix sums in double-double form so long series do not lose digits
+    // to cancellation.
+    std::vector<std::vector<double>> CalculateSMAs(const PriceSeries& data,
+                                                   const std::vector<int>& periods,
+                                                   bool compensated = true);
+    std::vector<double> CalculateEMA(const PriceSeries& data, int period);
     
     // Volatility Analysis
-    std::vector<double> CalculateVolatility(const std::vector<StockData>& data, int window);
-    std::vector<double> CalculateRollingVolatility(const std::vector<StockData>& data, int window);
+    std::vector<double> CalculateVolatility(const PriceSeries& data, int window);
+    std::vector<double> CalculateRollingVolatility(const PriceSeries& data, int window);
     
     // Returns
-    std::vector<double> CalculateReturns(const std::vector<StockData>& data);
+    std::vector<double> CalculateReturns(const PriceSeries& data);
+    // Returns of every ticker of a price panel, dated by the later of the
+    // two dates; a return is valid where both of its prices are
+    Panel CalculateReturns(const Panel& prices);
+    // Returns of several series over the dates they all share (an inner
+    // PanelBuilder join), so a holiday or gap in one series cannot shift
+    // the others
+    Panel CalculateAlignedReturns(const std::vector<PriceSeries>& multipleStocks,
+                                  const std::vector<std::string>& tickers);
     
     // Technical Indicators
-    std::vector<double> CalculateRSI(const std::vector<StockData>& data, int period = 14);
+    std::vector<double> CalculateRSI(const PriceSeries& data, int period = 14);
     struct MACDResult {
         std::vector<double> macd;
         std::vector<double> signal;
         std::vector<double> histogram;
     };
-    MACDResult CalculateMACD(const std::vector<StockData>& data, 
+    MACDResult CalculateMACD(const PriceSeries& data, 
                             int fastPeriod = 12, int slowPeriod = 26, int signalPeriod = 9);
     
     struct BollingerBands {
@@ -31,20 +51,109 @@ public:
         std::vector<double> middle;  // SMA
         std::vector<double> lower;
     };
-    BollingerBands CalculateBollingerBands(const std::vector<StockData>& data, 
+    BollingerBands CalculateBollingerBands(const PriceSeries& data, 
                                           int period = 20, double stdDevMultiplier = 2.0);
     
+    // Allocation-free overloads. These read any contiguous range of closes
+    // (a PriceSeries via Closes(), a window or date slice of one, mmapped
+    // memory) and write into caller-provided buffers. Each returns the
+    // number of values written per output: the layout's length, or 0 when
+    // the input is too short or a buffer is smaller than the layout. Values
+    // are bit-identical to the vector functions above, which wrap these.
+    //
+    //   auto layout = DataProcessor::RSILayout(closes.size(), 14);
+    //   processor.CalculateRSI(closes, 14, Span<double>(buffer, layout.length));
+    //   // buffer[k] is the RSI at bar layout.warmup + k
+    struct OutputLayout {
+        size_t warmup = 0;   // leading inputs with no output of their own
+        size_t length = 0;   // outputs produced; output k belongs to input warmup + k
+    };
+    static OutputLayout SMALayout(size_t count, int period);
+    static OutputLayout EMALayout(size_t count, int period);
+    static OutputLayout ReturnsLayout(size_t count);
+    static OutputLayout VolatilityLayout(size_t count, int window);
+    static OutputLayout RSILayout(size_t count, int period);
+    // The MACD line; signal and histogram have the same layout, but are only
+    // written when signalPeriod > 0
+    static OutputLayout MACDLayout(size_t count, int fastPeriod, int slowPeriod, int signalPeriod);
+    static OutputLayout BollingerLayout(size_t count, int period);
+
+    size_t CalculateSMA(Span<const double> closes, int period, Span<double> out);
+    size_t CalculateEMA(Span<const double> closes, int period, Span<double> out);
+    size_t CalculateReturns(Span<const double> closes, Span<double> out);
+    size_t CalculateVolatility(Span<const double> closes, int window, Span<double> out);
+    // Same output from already computed returns (CalculateReturns layout)
+    size_t CalculateVolatilityFromReturns(Span<const double> returns, int window, Span<double> out);
+    size_t CalculateRSI(Span<const double> closes, int period, Span<double> out);
+    size_t CalculateMACD(Span<const double> closes, int fastPeriod, int slowPeriod, int signalPeriod,
+                         Span<double> macd, Span<double> signal, Span<double> histogram);
+    size_t CalculateBollingerBands(Span<const double> closes, int period, double stdDevMultiplier,
+                                   Span<double> upper, Span<double> middle, Span<double> lower);
+    // Upper and lower bands around an already computed middle band (the
+    // SMA of the same closes and period)
+    size_t CalculateBollingerEnvelope(Span<const double> closes, Span<const double> middle,
+                                      int period, double stdDevMultiplier,
+                                      Span<double> upper, Span<double> lower);
+    
+    // Fused indicator pipeline. Every indicator enabled in the set is
+    // computed in one pass over the closes, sharing the intermediate state
+    // (returns, EMAs, rolling sums), instead of each Calculate* call
+    // re-walking the series. Outputs match the individual functions
+    // exactly, including their layouts and short-series behaviour.
+    struct IndicatorSet {
+        std::vector<int> smaPeriods;
+        std::vector<int> emaPeriods;
+        bool returns = false;
+        int volatilityWindow = 0;   // 0 = skip
+        int rsiPeriod = 0;          // 0 = skip
+        bool macd = false;
+        int macdFast = 12;
+        int macdSlow = 26;
+        int macdSignal = 9;
+        int bollingerPeriod = 0;    // 0 = skip
+        double bollingerStd = 2.0;
+    };
+    struct IndicatorResults {
+        std::vector<std::vector<double>> sma;  // one per IndicatorSet::smaPeriods
+        std::vector<std::vector<double>> ema;  // one per IndicatorSet::emaPeriods
+        std::vector<double> returns;
+        std::vector<double> volatility;
+        std::vector<double> rsi;
+        MACDResult macd;
+        BollingerBands bollinger;
+    };
+    IndicatorResults RunIndicatorPipeline(const PriceSeries& data, const IndicatorSet& indicators);
+    
     // Principal Component Analysis (PCA) for influential stocks
-    // Returns the top N influential stocks and their explained variance
+    // Eigen-decomposes the covariance of the stocks' returns and keeps the
+    // top N components. A stock's influence is its share of the variance
+    // those components explain: the eigenvalue-weighted sum of its squared
+    // loadings, normalized so that all stocks' scores add up to 1.
     struct PCAResult {
-        std::vector<std::string> influentialStocks;
-        std::vector<double> explainedVariance;
-        std::vector<std::vector<double>> principalComponents;
+        std::vector<std::string> influentialStocks;  // top N by influence
+        std::vector<double> influence;               // score of each influential stock
+        std::vector<double> explainedVariance;       // eigenvalue of each kept component
+        std::vector<double> explainedVarianceRatio;  // its share of the total variance
+        std::vector<std::vector<double>> principalComponents;  // loadings, [component][stock]
+        std::vector<double> eigenvalues;             // largest first; only the top N when randomized
         bool success;
     };
     
+    // Exact decomposes the full covariance matrix, O(stocks^3). Randomized
+    // finds only the top N components straight from the centered returns
+    // (see RandomizedPCA.h), at a cost that grows with N instead. Auto picks
+    // Randomized for large universes where N is a small fraction of them.
+    enum class PCAMethod { Auto, Exact, Randomized };
+    static constexpr size_t RandomizedPCAMinStocks = 500;
+    
+    PCAResult PerformPCA(const std::vector<PriceSeries>& multipleStocks,
+                        const std::vector<std::string>& tickers, int topN = 3,
+                        PCAMethod method = PCAMethod::Auto);
     PCAResult PerformPCA(const std::vector<std::vector<StockData>>& multipleStocks, 
-                        const std::vector<std::string>& tickers, int topN = 3);
+                        const std::vector<std::string>& tickers, int topN = 3,
+                        PCAMethod method = PCAMethod::Auto);
+    // On a returns panel without gaps, e.g. from CalculateAlignedReturns
+    PCAResult PerformPCA(const Panel& returns, int topN = 3, PCAMethod method = PCAMethod::Auto);
     
     // Statistical measures
     double CalculateMean(const std::vector<double>& values);
@@ -53,9 +162,26 @@ public:
     double CalculateMax(const std::vector<double>& values);
     double CalculateMin(const std::vector<double>& values);
     double CalculateMedian(const std::vector<double>& values);
+    double CalculateMean(Span<const double> values);
+    double CalculateStdDev(Span<const double> values);
+    double CalculateVariance(Span<const double> values);
+    double CalculateMax(Span<const double> values);
+    double CalculateMin(Span<const double> values);
     
     // Correlation
     double CalculateCorrelation(const std::vector<double>& x, const std::vector<double>& y);
+    double CalculateCorrelation(Span<const double> x, Span<const double> y);
+    // All pairwise correlations of equal-length series in one blocked,
+    // multithreaded pass (see CovarianceEngine); [i][j] equals
+    // CalculateCorrelation(series[i], series[j]). Empty on bad input.
+    std::vector<std::vector<double>> CalculateCorrelationMatrix(const std::vector<std::vector<double>>& series);
+    std::vector<std::vector<double>> CalculateCorrelationMatrix(const Panel& series);
+    
+    // Cross-sectional percentile rank of each valid, finite cell among
+    // those of its date: 0 for the lowest, 1 for the highest, ties sharing
+    // their mean rank (0.5 when a date has one value). Non-finite cells
+    // are left invalid. Row-major result.
+    Panel CalculateCrossSectionalRanks(const Panel& values);
     
 private:
     // Helper functions for PCA
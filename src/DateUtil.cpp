@@ -0,0 +1,56 @@
+#include "DateUtil.h"
+
+namespace DateUtil {
+
+static bool ParseDigits(const char* text, size_t count, int& value) {
+    value = 0;
+    for (size_t i = 0; i < count; ++i) {
+        unsigned digit = static_cast<unsigned>(text[i] - '0');
+        if (digit > 9) return false;
+        value = value * 10 + static_cast<int>(digit);
+    }
+    return true;
+}
+
+bool ParseDate(const char* text, size_t length, int32_t& days) {
+    if (length < 10 || text[4] != '-' || text[7] != '-') return false;
+    if (length > 10 && text[10] != ' ' && text[10] != 'T') return false;
+
+    int year, month, day;
+    if (!ParseDigits(text, 4, year) || !ParseDigits(text + 5, 2, month) ||
+        !ParseDigits(text + 8, 2, day)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 ||
+        static_cast<unsigned>(day) > DaysInMonth(year, static_cast<unsigned>(month))) {
+        return false;
+    }
+
+    days = DaysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    return true;
+}
+
+void FormatDate(int32_t days, char* buffer) {
+    CivilDate date = CivilFromDays(days);
+    // Market data never leaves 0000-9999, so a fixed-width layout is enough
+    unsigned year = static_cast<unsigned>(date.year) % 10000;
+    buffer[0] = static_cast<char>('0' + year / 1000);
+    buffer[1] = static_cast<char>('0' + year / 100 % 10);
+    buffer[2] = static_cast<char>('0' + year / 10 % 10);
+    buffer[3] = static_cast<char>('0' + year % 10);
+    buffer[4] = '-';
+    buffer[5] = static_cast<char>('0' + date.month / 10);
+    buffer[6] = static_cast<char>('0' + date.month % 10);
+    buffer[7] = '-';
+    buffer[8] = static_cast<char>('0' + date.day / 10);
+    buffer[9] = static_cast<char>('0' + date.day % 10);
+    buffer[10] = '\0';
+}
+
+std::string FormatDate(int32_t days) {
+    char buffer[11];
+    FormatDate(days, buffer);
+    return std::string(buffer);
+}
+
+} // namespace DateUtil
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Calendar helpers for the integer dates stored in StockData/PriceSeries.
+// Dates are days since 1970-01-01 (proleptic Gregorian, UTC), so joins and
+// range lookups are plain integer comparisons and no row owns a string.
+namespace DateUtil {
+
+struct CivilDate {
+    int year;
+    unsigned month;  // 1-12
+    unsigned day;    // 1-31
+};
+
+// Howard Hinnant's days_from_civil: exact for any year representable in int
+constexpr int32_t DaysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2 ? 1 : 0;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return static_cast<int32_t>(era * 146097 + static_cast<int>(doe) - 719468);
+}
+
+constexpr CivilDate CivilFromDays(int32_t days) {
+    const int z = days + 719468;
+    const int era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned day = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned month = mp < 10 ? mp + 3 : mp - 9;
+    return { static_cast<int>(yoe) + era * 400 + (month <= 2 ? 1 : 0), month, day };
+}
+
+constexpr bool IsLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+constexpr unsigned DaysInMonth(int year, unsigned month) {
+    constexpr unsigned days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return month == 2 && IsLeapYear(year) ? 29 : days[month - 1];
+}
+
+constexpr int64_t SecondsPerDay = 86400;
+
+constexpr int64_t DaysToUnixSeconds(int32_t days) {
+    return static_cast<int64_t>(days) * SecondsPerDay;
+}
+
+// Floors so that pre-1970 timestamps land on the right day
+constexpr int32_t UnixSecondsToDays(int64_t seconds) {
+    return static_cast<int32_t>(seconds >= 0 ? seconds / SecondsPerDay
+                                             : (seconds - (SecondsPerDay - 1)) / SecondsPerDay);
+}
+
+static_assert(DaysFromCivil(1970, 1, 1) == 0, "epoch must be day 0");
+static_assert(DaysFromCivil(2024, 1, 1) == 19723, "days_from_civil mismatch");
+static_assert(CivilFromDays(19723).year == 2024, "civil_from_days mismatch");
+
+// Parses "YYYY-MM-DD" (optionally followed by a ' ' or 'T' time part, which
+// is ignored). Returns false and leaves `days` untouched on malformed input.
+bool ParseDate(const char* text, size_t length, int32_t& days);
+inline bool ParseDate(const std::string& text, int32_t& days) {
+    return ParseDate(text.data(), text.size(), days);
+}
+
+// Formats as "YYYY-MM-DD"; `buffer` must hold at least 11 chars
+void FormatDate(int32_t days, char* buffer);
+std::string FormatDate(int32_t days);
+
+} // namespace DateUtil
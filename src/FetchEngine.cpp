@@ -0,0 +1,327 @@
+#include "FetchEngine.h"
+#include "HttpClient.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+// Upper bound on one curl_multi_poll wait; wakeups normally end it sooner
+const int PollTimeoutMs = 1000;
+
+// curl_multi_poll and curl_multi_wakeup need libcurl 7.68.0. Older
+// versions cannot interrupt a wait, so the loop waits in slices this long
+// and notices new submissions and shutdown on the next one.
+const int FallbackPollMs = 10;
+
+void WakeUp(CURLM* multi) {
+#if LIBCURL_VERSION_NUM >= 0x074400
+    curl_multi_wakeup(multi);
+#else
+    (void)multi;
+#endif
+}
+
+// Returns on socket activity, timeout, or a WakeUp (Submit, shutdown)
+void WaitForActivity(CURLM* multi, int timeoutMs) {
+#if LIBCURL_VERSION_NUM >= 0x074400
+    curl_multi_poll(multi, nullptr, 0, timeoutMs, nullptr);
+#else
+    timeoutMs = std::min(timeoutMs, FallbackPollMs);
+    int descriptors = 0;
+    curl_multi_wait(multi, nullptr, 0, timeoutMs, &descriptors);
+    // curl_multi_wait returns at once when there is nothing to wait on
+    if (descriptors == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+    }
+#endif
+}
+
+} // namespace
+
+FetchEngine::FetchEngine(size_t inFlightLimit, size_t perHostLimit, long timeout)
+    : maxInFlight(std::max<size_t>(1, inFlightLimit)),
+      maxPerHost(std::max<size_t>(1, perHostLimit)),
+      timeoutSeconds(timeout) {
+    HttpClient::InitializeLibrary();
+
+    multi = curl_multi_init();
+    if (!multi) {
+        std::cerr << "Error: Failed to initialize CURL multi handle\n";
+        return;
+    }
+    curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(maxPerHost));
+    curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, static_cast<long>(maxInFlight));
+    curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, static_cast<long>(maxInFlight));
+
+    loopThread = std::thread([this]() { EventLoop(); });
+}
+
+FetchEngine::~FetchEngine() {
+    if (!multi) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    WakeUp(multi);
+    loopThread.join();
+
+    for (CURL* handle : idleHandles) {
+        curl_easy_cleanup(handle);
+    }
+    curl_multi_cleanup(multi);
+}
+
+void FetchEngine::SetFixtures(std::shared_ptr<HttpFixtures> store) {
+    std::lock_guard<std::mutex> lock(mutex);
+    fixtures = std::move(store);
+}
+
+std::future<FetchResult> FetchEngine::Submit(const std::string& url) {
+    return Submit(url, nullptr);
+}
+
+std::future<FetchResult> FetchEngine::Submit(const std::string& url, DataSink sink) {
+    auto transfer = std::make_unique<Transfer>();
+    transfer->result.url = url;
+    transfer->sink = std::move(sink);
+    std::future<FetchResult> future = transfer->promise.get_future();
+
+    if (url.empty() || !multi) {
+        transfer->result.error = url.empty() ? "Empty URL provided" : "CURL multi handle unavailable";
+        transfer->promise.set_value(std::move(transfer->result));
+        return future;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued.push_back(std::move(transfer));
+    }
+    WakeUp(multi);
+    return future;
+}
+
+std::vector<FetchResult> FetchEngine::FetchAll(const std::vector<std::string>& urls) {
+    std::vector<std::future<FetchResult>> pending;
+    pending.reserve(urls.size());
+    for (const auto& url : urls) {
+        pending.push_back(Submit(url));
+    }
+
+    std::vector<FetchResult> results;
+    results.reserve(urls.size());
+    for (auto& future : pending) {
+        results.push_back(future.get());
+    }
+    return results;
+}
+
+size_t FetchEngine::WriteBody(void* contents, size_t size, size_t nmemb, void* target) {
+    size_t totalSize = size * nmemb;
+    auto* transfer = static_cast<Transfer*>(target);
+    if (!transfer->sink) {
+        transfer->result.body.append(static_cast<char*>(contents), totalSize);
+        return totalSize;
+    }
+
+    // Error bodies are drained but never reach the sink
+    long responseCode = 0;
+    curl_easy_getinfo(transfer->handle, CURLINFO_RESPONSE_CODE, &responseCode);
+    if (responseCode != 200) {
+        return totalSize;
+    }
+    if (transfer->recording) {
+        transfer->recorded.append(static_cast<char*>(contents), totalSize);
+    }
+    return transfer->sink(static_cast<const char*>(contents), totalSize) ? totalSize : 0;
+}
+
+void FetchEngine::EventLoop() {
+    for (;;) {
+        StartQueued();
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        int remaining = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi, &remaining)) {
+            if (message->msg == CURLMSG_DONE) {
+                FinishTransfer(message->easy_handle, message->data.result);
+            }
+        }
+        FinishReplays();
+
+        // Wake up in time for the next replayed transfer to complete
+        int timeoutMs = PollTimeoutMs;
+        for (const auto& transfer : active) {
+            if (!transfer->handle) {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    transfer->readyAt - Clock::now());
+                timeoutMs = std::min<int>(timeoutMs, std::max<int>(0, static_cast<int>(wait.count()) + 1));
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping && queued.empty() && active.empty()) {
+                return;
+            }
+            // Slots freed by finished transfers: refill before waiting
+            bool replaysFull = fixtures && fixtures->GetMode() == HttpFixtures::Replay &&
+                               ActiveReplays() >= maxPerHost;
+            if (!queued.empty() && active.size() < maxInFlight && !replaysFull) {
+                continue;
+            }
+        }
+
+        WaitForActivity(multi, timeoutMs);
+    }
+}
+
+void FetchEngine::StartQueued() {
+    while (active.size() < maxInFlight) {
+        std::unique_ptr<Transfer> transfer;
+        std::shared_ptr<HttpFixtures> store;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (queued.empty()) {
+                return;
+            }
+            store = fixtures;
+            // Replayed transfers all count against one simulated host
+            if (store && store->GetMode() == HttpFixtures::Replay && ActiveReplays() >= maxPerHost) {
+                return;
+            }
+            transfer = std::move(queued.front());
+            queued.pop_front();
+        }
+
+        if (store && store->GetMode() == HttpFixtures::Replay) {
+            if (StartReplay(*transfer, *store)) {
+                active.push_back(std::move(transfer));
+            } else {
+                transfer->promise.set_value(std::move(transfer->result));
+            }
+            continue;
+        }
+        transfer->recording = store != nullptr;
+
+        CURL* handle = nullptr;
+        if (!idleHandles.empty()) {
+            handle = idleHandles.back();
+            idleHandles.pop_back();
+        } else {
+            handle = curl_easy_init();
+        }
+        if (!handle) {
+            transfer->result.error = "Failed to initialize CURL";
+            transfer->promise.set_value(std::move(transfer->result));
+            continue;
+        }
+
+        transfer->handle = handle;
+        curl_easy_setopt(handle, CURLOPT_URL, transfer->result.url.c_str());
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, WriteBody);
+        curl_easy_setopt(handle, CURLOPT_WRITEDATA, transfer.get());
+        curl_easy_setopt(handle, CURLOPT_TIMEOUT, timeoutSeconds);
+        curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+        curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(handle, CURLOPT_PRIVATE, transfer.get());
+
+        curl_multi_add_handle(multi, handle);
+        active.push_back(std::move(transfer));
+    }
+}
+
+void FetchEngine::FinishTransfer(CURL* handle, CURLcode code) {
+    Transfer* finished = nullptr;
+    curl_easy_getinfo(handle, CURLINFO_PRIVATE, &finished);
+
+    auto it = std::find_if(active.begin(), active.end(),
+                           [finished](const std::unique_ptr<Transfer>& t) { return t.get() == finished; });
+    if (it == active.end()) {
+        return;
+    }
+    std::unique_ptr<Transfer> transfer = std::move(*it);
+    active.erase(it);
+
+    FetchResult& result = transfer->result;
+    if (code != CURLE_OK) {
+        result.error = curl_easy_strerror(code);
+        result.body.clear();
+    } else {
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &result.status);
+        if (transfer->recording) {
+            std::shared_ptr<HttpFixtures> store;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                store = fixtures;
+            }
+            if (store) {
+                store->Save(result.url, result.status, transfer->sink ? transfer->recorded : result.body);
+            }
+        }
+        if (result.status != 200) {
+            result.error = "HTTP status " + std::to_string(result.status);
+            result.body.clear();
+        }
+    }
+
+    // Keep the handle for the next queued transfer; the multi handle owns
+    // the connection cache, so the connection stays open either way
+    curl_multi_remove_handle(multi, handle);
+    curl_easy_reset(handle);
+    if (idleHandles.size() < maxInFlight) {
+        idleHandles.push_back(handle);
+    } else {
+        curl_easy_cleanup(handle);
+    }
+
+    transfer->promise.set_value(std::move(result));
+}
+
+size_t FetchEngine::ActiveReplays() const {
+    return static_cast<size_t>(std::count_if(active.begin(), active.end(),
+                                             [](const std::unique_ptr<Transfer>& t) { return !t->handle; }));
+}
+
+bool FetchEngine::StartReplay(Transfer& transfer, const HttpFixtures& store) {
+    if (!store.Load(transfer.result.url, transfer.replayStatus, transfer.replayBody)) {
+        transfer.result.error = "No fixture for URL";
+        return false;
+    }
+    transfer.readyAt = Clock::now() + store.Latency() + store.TransferTime(transfer.replayBody.size());
+    return true;
+}
+
+void FetchEngine::FinishReplays() {
+    Clock::time_point now = Clock::now();
+    for (size_t i = 0; i < active.size();) {
+        if (active[i]->handle || active[i]->readyAt > now) {
+            ++i;
+            continue;
+        }
+        std::unique_ptr<Transfer> transfer = std::move(active[i]);
+        active.erase(active.begin() + static_cast<std::ptrdiff_t>(i));
+
+        FetchResult& result = transfer->result;
+        result.status = transfer->replayStatus;
+        if (result.status != 200) {
+            result.error = "HTTP status " + std::to_string(result.status);
+        } else if (!transfer->sink) {
+            result.body = std::move(transfer->replayBody);
+        } else {
+            // Same chunking as a live transfer, so sinks see realistic writes
+            const std::string& body = transfer->replayBody;
+            for (size_t offset = 0; offset < body.size(); offset += CURL_MAX_WRITE_SIZE) {
+                size_t length = std::min<size_t>(CURL_MAX_WRITE_SIZE, body.size() - offset);
+                if (!transfer->sink(body.data() + offset, length)) {
+                    result.error = curl_easy_strerror(CURLE_WRITE_ERROR);
+                    break;
+                }
+            }
+        }
+        transfer->promise.set_value(std::move(result));
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <curl/curl.h>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "HttpFixtures.h"
+
+// Outcome of one GET issued through FetchEngine
+struct FetchResult {
+    std::string url;
+    std::string body;    // response body; only kept for HTTP 200 without a sink
+    long status = 0;     // HTTP status, 0 if the transfer itself failed
+    std::string error;   // empty on success
+};
+
+// Asynchronous HTTP GET engine on a curl multi handle. A single event-loop
+// thread drives every transfer, so hundreds of requests overlap their
+// round-trips without a thread each. At most `maxInFlight` transfers are
+// active at once (the rest wait in a FIFO queue) and curl opens at most
+// `maxPerHost` connections to any one host, reusing them between
+// transfers. Submit may be called from any thread; the destructor finishes
+// queued and active transfers before joining the loop.
+class FetchEngine {
+public:
+    explicit FetchEngine(size_t maxInFlight = 32, size_t maxPerHost = 6, long timeoutSeconds = 30);
+    ~FetchEngine();
+
+    FetchEngine(const FetchEngine&) = delete;
+    FetchEngine& operator=(const FetchEngine&) = delete;
+
+    // Receives body bytes of an HTTP 200 response as they arrive; return
+    // false to abort the transfer. Runs on the event-loop thread.
+    using DataSink = std::function<bool(const char* data, size_t length)>;
+
+    std::future<FetchResult> Submit(const std::string& url);
+
+    // Streams the body into `sink` instead of FetchResult::body, so parsing
+    // overlaps the download and the body is never buffered. On failure the
+    // sink may already have seen a partial body.
+    std::future<FetchResult> Submit(const std::string& url, DataSink sink);
+
+    // Submits every URL and waits; results are in input order
+    std::vector<FetchResult> FetchAll(const std::vector<std::string>& urls);
+
+    // Records or replays responses (see HttpFixtures). Replayed transfers
+    // obey maxInFlight and maxPerHost (as if all went to one host) but
+    // complete on a timer instead of a socket, so concurrency effects can
+    // be measured offline. Takes effect for transfers started after the
+    // call.
+    void SetFixtures(std::shared_ptr<HttpFixtures> store);
+
+    size_t MaxInFlight() const { return maxInFlight; }
+    size_t MaxPerHost() const { return maxPerHost; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Transfer {
+        FetchResult result;
+        std::promise<FetchResult> promise;
+        DataSink sink;
+        CURL* handle = nullptr;          // nullptr while replaying
+        bool recording = false;
+        std::string recorded;            // streamed body kept for the fixture
+        Clock::time_point readyAt;       // replay completion time
+        long replayStatus = 0;
+        std::string replayBody;
+    };
+
+    static size_t WriteBody(void* contents, size_t size, size_t nmemb, void* transfer);
+
+    void EventLoop();
+    void StartQueued();
+    void FinishTransfer(CURL* handle, CURLcode code);
+    void FinishReplays();
+    bool StartReplay(Transfer& transfer, const HttpFixtures& store);
+    size_t ActiveReplays() const;
+
+    size_t maxInFlight;
+    size_t maxPerHost;
+    long timeoutSeconds;
+
+    CURLM* multi = nullptr;
+    std::thread loopThread;
+
+    // Guarded by `mutex`: shared between Submit and the loop thread
+    std::mutex mutex;
+    std::deque<std::unique_ptr<Transfer>> queued;
+    std::shared_ptr<HttpFixtures> fixtures;
+    bool stopping = false;
+
+    // Owned by the loop thread
+    std::vector<std::unique_ptr<Transfer>> active;
+    std::vector<CURL*> idleHandles;
+};
@@ -0,0 +1,270 @@
+#include "HistoryCache.h"
+#include "ColumnStore.h"
+#include "DateUtil.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* RangesHeader = "# StockSense history ranges v1: [begin, end) per line";
+
+// Sorts and merges overlapping or touching ranges
+std::vector<DateRange> Normalize(std::vector<DateRange> ranges) {
+    ranges.erase(std::remove_if(ranges.begin(), ranges.end(),
+                                [](const DateRange& r) { return r.end <= r.begin; }),
+                 ranges.end());
+    std::sort(ranges.begin(), ranges.end(),
+              [](const DateRange& a, const DateRange& b) { return a.begin < b.begin; });
+
+    std::vector<DateRange> merged;
+    for (const DateRange& range : ranges) {
+        if (!merged.empty() && range.begin <= merged.back().end) {
+            merged.back().end = std::max(merged.back().end, range.end);
+        } else {
+            merged.push_back(range);
+        }
+    }
+    return merged;
+}
+
+// Rows of `series` dated in [range.begin, range.end); `series` is sorted
+PriceSeries Slice(const PriceSeries& series, DateRange range) {
+    auto first = std::lower_bound(series.date.begin(), series.date.end(), range.begin);
+    auto last = std::lower_bound(first, series.date.end(), range.end);
+    size_t begin = static_cast<size_t>(first - series.date.begin());
+    size_t end = static_cast<size_t>(last - series.date.begin());
+
+    PriceSeries slice;
+    slice.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        slice.push_back(series.Row(i));
+    }
+    return slice;
+}
+
+bool FileExists(const std::string& path) {
+    return std::ifstream(path).good();
+}
+
+} // namespace
+
+HistoryCache::HistoryCache(StockDataLoader& historyLoader, const std::string& cacheDirectory)
+    : loader(historyLoader), directory(cacheDirectory) {
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec) {
+        std::cerr << "Warning: Could not create history cache directory " << directory
+                  << ": " << ec.message() << "\n";
+    }
+}
+
+std::string HistoryCache::BarsPath(const std::string& ticker) const {
+    return (fs::path(directory) / (ticker + ".scol")).string();
+}
+
+std::string HistoryCache::RangesPath(const std::string& ticker) const {
+    return (fs::path(directory) / (ticker + ".ranges")).string();
+}
+
+std::vector<DateRange> HistoryCache::StoredRanges(const std::string& ticker) const {
+    std::vector<DateRange> ranges;
+    std::ifstream file(RangesPath(ticker));
+    if (!file.is_open()) {
+        return ranges;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream fields(line);
+        std::string first, last;
+        DateRange range;
+        if (!(fields >> first >> last) || !DateUtil::ParseDate(first, range.begin) ||
+            !DateUtil::ParseDate(last, range.end)) {
+            std::cerr << "Warning: Ignoring malformed line in " << RangesPath(ticker) << "\n";
+            continue;
+        }
+        ranges.push_back(range);
+    }
+    return Normalize(ranges);
+}
+
+bool HistoryCache::WriteRanges(const std::string& ticker, const std::vector<DateRange>& ranges) const {
+    std::string path = RangesPath(ticker);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open " << tempPath << " for writing\n";
+            return false;
+        }
+        file << RangesHeader << "\n";
+        for (const DateRange& range : ranges) {
+            file << DateUtil::FormatDate(range.begin) << " " << DateUtil::FormatDate(range.end) << "\n";
+        }
+        if (!file) {
+            std::cerr << "Error: Failed writing " << tempPath << "\n";
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error: Could not move " << tempPath << " to " << path << "\n";
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::vector<DateRange> HistoryCache::MissingRanges(const std::vector<DateRange>& stored,
+                                                   DateRange wanted) {
+    std::vector<DateRange> missing;
+    int32_t cursor = wanted.begin;
+    for (const DateRange& range : stored) {
+        if (range.end <= cursor) continue;
+        if (range.begin >= wanted.end) break;
+        if (range.begin > cursor) {
+            missing.push_back({cursor, range.begin});
+        }
+        cursor = std::max(cursor, range.end);
+    }
+    if (cursor < wanted.end) {
+        missing.push_back({cursor, wanted.end});
+    }
+    return missing;
+}
+
+bool HistoryCache::Store(const std::string& ticker, const PriceSeries& fetched,
+                         const std::vector<DateRange>& fetchedRanges) {
+    // Fetched rows sorted by date; the last copy of a date wins
+    std::vector<StockData> incoming = fetched.ToRows();
+    std::stable_sort(incoming.begin(), incoming.end(),
+                     [](const StockData& a, const StockData& b) { return a.date < b.date; });
+
+    std::string barsPath = BarsPath(ticker);
+    PriceSeries existing;
+    if (FileExists(barsPath)) {
+        existing = ColumnStore::Map(barsPath);
+    }
+
+    PriceSeries merged;
+    merged.reserve(existing.size() + incoming.size());
+    size_t e = 0;
+    size_t n = 0;
+    while (e < existing.size() || n < incoming.size()) {
+        if (n < incoming.size() && n + 1 < incoming.size() && incoming[n + 1].date == incoming[n].date) {
+            ++n;  // superseded by a later duplicate
+            continue;
+        }
+        if (n >= incoming.size() || (e < existing.size() && existing.date[e] < incoming[n].date)) {
+            merged.push_back(existing.Row(e++));
+        } else {
+            if (e < existing.size() && existing.date[e] == incoming[n].date) {
+                ++e;  // replaced by the fetched bar
+            }
+            merged.push_back(incoming[n++]);
+        }
+    }
+
+    if (!merged.empty() && !ColumnStore::Write(barsPath, merged)) {
+        return false;
+    }
+
+    // Only after the bars are durable do the ranges claim them
+    std::vector<DateRange> ranges = StoredRanges(ticker);
+    ranges.insert(ranges.end(), fetchedRanges.begin(), fetchedRanges.end());
+    return WriteRanges(ticker, Normalize(ranges));
+}
+
+PriceSeries HistoryCache::Load(const std::string& ticker, const std::string& startDate,
+                               const std::string& endDate) {
+    return std::move(LoadBatch({ticker}, startDate, endDate).front().data);
+}
+
+std::vector<BatchLoadResult> HistoryCache::LoadBatch(const std::vector<std::string>& tickers,
+                                                     const std::string& startDate,
+                                                     const std::string& endDate) {
+    std::vector<BatchLoadResult> results(tickers.size());
+    for (size_t i = 0; i < tickers.size(); ++i) {
+        results[i].source = tickers[i];
+    }
+
+    DateRange wanted;
+    if (!DateUtil::ParseDate(startDate, wanted.begin) || !DateUtil::ParseDate(endDate, wanted.end) ||
+        wanted.end <= wanted.begin) {
+        std::cerr << "Error: Invalid date range " << startDate << " to " << endDate << "\n";
+        for (auto& result : results) {
+            result.error = "Invalid date range";
+        }
+        return results;
+    }
+
+    std::lock_guard<std::mutex> lock(updateMutex);
+
+    // Group tickers by identical gap so each gap is one batch fetch
+    std::map<std::pair<int32_t, int32_t>, std::vector<size_t>> gaps;
+    for (size_t i = 0; i < tickers.size(); ++i) {
+        for (const DateRange& gap : MissingRanges(StoredRanges(tickers[i]), wanted)) {
+            gaps[{gap.begin, gap.end}].push_back(i);
+        }
+    }
+
+    int32_t today = DateUtil::UnixSecondsToDays(static_cast<int64_t>(std::time(nullptr)));
+    std::vector<PriceSeries> fetched(tickers.size());
+    std::vector<std::vector<DateRange>> covered(tickers.size());
+    std::vector<bool> changed(tickers.size(), false);
+
+    for (const auto& gap : gaps) {
+        std::vector<std::string> group;
+        for (size_t i : gap.second) {
+            group.push_back(tickers[i]);
+        }
+        auto batch = loader.FetchHistories(group, DateUtil::FormatDate(gap.first.first),
+                                           DateUtil::FormatDate(gap.first.second));
+        rangesFetched += group.size();
+
+        for (size_t j = 0; j < batch.size(); ++j) {
+            size_t i = gap.second[j];
+            if (!batch[j].error.empty()) {
+                results[i].error = batch[j].error;
+                continue;  // leave the gap open; it is retried next time
+            }
+            // From here on the fetch succeeded, so the gap is covered even
+            // when it held no bars
+            const PriceSeries& bars = batch[j].data;
+            barsFetched += bars.size();
+            for (size_t r = 0; r < bars.size(); ++r) {
+                fetched[i].push_back(bars.Row(r));
+            }
+            int32_t coveredEnd = std::min(gap.first.second, today);
+            if (coveredEnd > gap.first.first) {
+                covered[i].push_back({gap.first.first, coveredEnd});
+            }
+            changed[i] = true;
+        }
+    }
+
+    for (size_t i = 0; i < tickers.size(); ++i) {
+        std::string barsPath = BarsPath(tickers[i]);
+        if (changed[i] && !Store(tickers[i], fetched[i], covered[i])) {
+            std::cerr << "Warning: Could not update history cache for " << tickers[i] << "\n";
+            results[i].data = std::move(fetched[i]);  // still hand back what arrived
+        } else if (FileExists(barsPath)) {
+            results[i].data = Slice(ColumnStore::Map(barsPath), wanted);
+        }
+    }
+    return results;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "StockDataLoader.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Half-open span of days since epoch, [begin, end)
+struct DateRange {
+    int32_t begin;
+    int32_t end;
+};
+
+// Incremental on-disk history cache in front of StockDataLoader.
+//
+// Each ticker is stored as <directory>/<ticker>.scol (a ColumnStore) plus
+// <directory>/<ticker>.ranges, a text sidecar listing the date ranges that
+// have been fetched. Ranges are tracked separately from the bars so that
+// weekends and holidays inside a fetched range, or a whole gap with no
+// bars (before the listing date, a holiday week), are not re-requested;
+// only a gap whose fetch or parse failed is left open and retried. A load
+// computes which parts of the requested range are not covered, fetches only
+// those, merges them into the stored series (fetched bars win on the same
+// date) and rewrites the store. Bars are written before the ranges, each by
+// temp file and rename, so a crash can at worst cause a range to be fetched
+// again.
+//
+// Days from today onward are never recorded as covered, since the current
+// session's bar may still change; a nightly refresh therefore fetches just
+// the newest bar per ticker.
+class HistoryCache {
+public:
+    HistoryCache(StockDataLoader& loader, const std::string& directory);
+
+    // Bars in [startDate, endDate) (YYYY-MM-DD), fetching whatever is missing
+    PriceSeries Load(const std::string& ticker, const std::string& startDate,
+                     const std::string& endDate);
+
+    // Batch variant; tickers that share the same gap are fetched together
+    // through StockDataLoader::FetchHistories. Results are in input order.
+    // `error` is set when a gap could not be fetched, and `data` then holds
+    // whatever was already stored; a range with no bars is empty, not an
+    // error.
+    std::vector<BatchLoadResult> LoadBatch(const std::vector<std::string>& tickers,
+                                           const std::string& startDate,
+                                           const std::string& endDate);
+
+    // Ranges recorded as fetched for `ticker`, sorted and non-overlapping
+    std::vector<DateRange> StoredRanges(const std::string& ticker) const;
+
+    // Parts of `wanted` not covered by `stored` (sorted, non-overlapping)
+    static std::vector<DateRange> MissingRanges(const std::vector<DateRange>& stored,
+                                                DateRange wanted);
+
+    // Gap requests issued and bars received since construction
+    size_t RangesFetched() const { return rangesFetched; }
+    size_t BarsFetched() const { return barsFetched; }
+
+private:
+    std::string BarsPath(const std::string& ticker) const;
+    std::string RangesPath(const std::string& ticker) const;
+    bool WriteRanges(const std::string& ticker, const std::vector<DateRange>& ranges) const;
+    bool Store(const std::string& ticker, const PriceSeries& fetched,
+               const std::vector<DateRange>& fetchedRanges);
+
+    StockDataLoader& loader;
+    std::string directory;
+    std::mutex updateMutex;  // one read-modify-write cycle at a time
+    size_t rangesFetched = 0;
+    size_t barsFetched = 0;
+};
@@ -0,0 +1,193 @@
+#include "HttpClient.h"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+struct StreamTarget {
+    CURL* handle;
+    const HttpClient::DataSink* sink;
+};
+
+size_t WriteToSink(void* contents, size_t size, size_t nmemb, void* target) {
+    size_t totalSize = size * nmemb;
+    auto* stream = static_cast<StreamTarget*>(target);
+
+    // Headers are complete by the first body byte; bodies of error
+    // responses are drained but never reach the sink
+    long responseCode = 0;
+    curl_easy_getinfo(stream->handle, CURLINFO_RESPONSE_CODE, &responseCode);
+    if (responseCode != 200) {
+        return totalSize;
+    }
+    return (*stream->sink)(static_cast<const char*>(contents), totalSize) ? totalSize : 0;
+}
+
+} // namespace
+
+void HttpClient::InitializeLibrary() {
+    // curl_global_init is not thread-safe, so it must run exactly once
+    static std::once_flag initOnce;
+    std::call_once(initOnce, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+}
+
+HttpClient::HttpClient(long timeout, size_t idleLimit)
+    : timeoutSeconds(timeout), maxIdleHandles(idleLimit) {
+    InitializeLibrary();
+
+    share = curl_share_init();
+    if (!share) {
+        std::cerr << "Warning: curl_share_init failed; connections will not be shared\n";
+        return;
+    }
+    curl_share_setopt(share, CURLSHOPT_LOCKFUNC, LockShared);
+    curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, UnlockShared);
+    curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900  // connection cache sharing: 7.57.0
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+}
+
+HttpClient::~HttpClient() {
+    // Easy handles must let go of the share before it can be destroyed
+    for (CURL* handle : idleHandles) {
+        curl_easy_cleanup(handle);
+    }
+    if (share) {
+        curl_share_cleanup(share);
+    }
+}
+
+void HttpClient::LockShared(CURL*, curl_lock_data data, curl_lock_access, void* client) {
+    static_cast<HttpClient*>(client)->shareLocks[data].lock();
+}
+
+void HttpClient::UnlockShared(CURL*, curl_lock_data data, void* client) {
+    static_cast<HttpClient*>(client)->shareLocks[data].unlock();
+}
+
+CURL* HttpClient::AcquireHandle() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (!idleHandles.empty()) {
+            CURL* handle = idleHandles.back();
+            idleHandles.pop_back();
+            return handle;
+        }
+    }
+    return curl_easy_init();
+}
+
+void HttpClient::ReleaseHandle(CURL* handle) {
+    // Reset options but keep the handle's own connection and DNS state
+    curl_easy_reset(handle);
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (idleHandles.size() < maxIdleHandles) {
+            idleHandles.push_back(handle);
+            return;
+        }
+    }
+    curl_easy_cleanup(handle);
+}
+
+std::string HttpClient::Get(const std::string& url) {
+    std::string body;
+    bool ok = Get(url, [&body](const char* data, size_t length) {
+        body.append(data, length);
+        return true;
+    });
+    if (!ok) {
+        body.clear();
+    }
+    return body;
+}
+
+bool HttpClient::Replay(const std::string& url, const DataSink& sink) {
+    long responseCode = 0;
+    std::string body;
+    if (!fixtures->Load(url, responseCode, body)) {
+        std::cerr << "Replay Error: No fixture for " << url << "\n";
+        return false;
+    }
+
+    std::this_thread::sleep_for(fixtures->Latency());
+    if (responseCode != 200) {
+        std::cerr << "HTTP Error: Received status code " << responseCode << "\n";
+        return false;
+    }
+
+    // Hand the body over in curl-sized chunks, paced at the simulated bandwidth
+    for (size_t offset = 0; offset < body.size(); offset += CURL_MAX_WRITE_SIZE) {
+        size_t length = std::min<size_t>(CURL_MAX_WRITE_SIZE, body.size() - offset);
+        std::this_thread::sleep_for(fixtures->TransferTime(length));
+        if (!sink(body.data() + offset, length)) {
+            std::cerr << "Replay Error: Transfer aborted by receiver\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HttpClient::Get(const std::string& url, const DataSink& sink) {
+    if (url.empty()) {
+        std::cerr << "Error: Empty URL provided\n";
+        return false;
+    }
+
+    if (fixtures && fixtures->GetMode() == HttpFixtures::Replay) {
+        return Replay(url, sink);
+    }
+
+    // When recording, keep a copy of the body on its way to the sink
+    bool recording = fixtures && fixtures->GetMode() == HttpFixtures::Record;
+    std::string recorded;
+    DataSink tee;
+    if (recording) {
+        tee = [&recorded, &sink](const char* data, size_t length) {
+            recorded.append(data, length);
+            return sink(data, length);
+        };
+    }
+
+    CURL* curl = AcquireHandle();
+    if (!curl) {
+        std::cerr << "Error: Failed to initialize CURL\n";
+        return false;
+    }
+
+    StreamTarget target{curl, recording ? &tee : &sink};
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteToSink);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &target);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeoutSeconds);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);  // required when used from worker threads
+    if (share) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, share);
+    }
+
+    CURLcode res = curl_easy_perform(curl);
+    bool ok = true;
+
+    if (res != CURLE_OK) {
+        std::cerr << "CURL Error: " << curl_easy_strerror(res) << "\n";
+        ok = false;
+    } else {
+        long responseCode = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &responseCode);
+        if (responseCode != 200) {
+            std::cerr << "HTTP Error: Received status code " << responseCode << "\n";
+            ok = false;
+        }
+        if (recording) {
+            fixtures->Save(url, responseCode, recorded);
+        }
+    }
+
+    ReleaseHandle(curl);
+    return ok;
+}
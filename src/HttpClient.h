@@ -0,0 +1,61 @@
+#pragma once
+#include <curl/curl.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "HttpFixtures.h"
+
+// Thread-safe HTTP GET client built on a pool of long-lived curl easy
+// handles. Every handle is attached to one CURLSH that shares the DNS,
+// connection and TLS session caches, so repeated requests to the same
+// host reuse an open connection instead of re-resolving and
+// re-handshaking. Any number of threads may call Get concurrently.
+class HttpClient {
+public:
+    explicit HttpClient(long timeoutSeconds = 30, size_t maxIdleHandles = 16);
+    ~HttpClient();
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    // Receives response body bytes as they arrive off the socket; return
+    // false to abort the transfer
+    using DataSink = std::function<bool(const char* data, size_t length)>;
+
+    // Returns the response body for HTTP 200, or an empty string after
+    // logging the transport or HTTP error
+    std::string Get(const std::string& url);
+
+    // Streaming variant: the body of an HTTP 200 response is handed to
+    // `sink` chunk by chunk and never buffered here. Error responses are
+    // not passed on. Returns false (after logging) if the transfer failed,
+    // in which case `sink` may already have seen a partial body.
+    bool Get(const std::string& url, const DataSink& sink);
+
+    // Records responses to, or replays them from, a fixture directory (see
+    // HttpFixtures); nullptr goes back to live requests. Set this before
+    // issuing requests.
+    void SetFixtures(std::shared_ptr<HttpFixtures> store) { fixtures = std::move(store); }
+
+    // Runs curl_global_init exactly once per process; every component that
+    // creates curl handles calls this first
+    static void InitializeLibrary();
+
+private:
+    bool Replay(const std::string& url, const DataSink& sink);
+    CURL* AcquireHandle();
+    void ReleaseHandle(CURL* handle);
+
+    static void LockShared(CURL* handle, curl_lock_data data, curl_lock_access access, void* client);
+    static void UnlockShared(CURL* handle, curl_lock_data data, void* client);
+
+    long timeoutSeconds;
+    size_t maxIdleHandles;
+    CURLSH* share = nullptr;
+    std::mutex shareLocks[CURL_LOCK_DATA_LAST];
+    std::mutex poolMutex;
+    std::vector<CURL*> idleHandles;
+    std::shared_ptr<HttpFixtures> fixtures;
+};
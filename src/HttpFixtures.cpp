@@ -0,0 +1,132 @@
+#include "HttpFixtures.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* FixtureMagic = "STOCKSENSE-FIXTURE 1";
+
+} // namespace
+
+HttpFixtures::HttpFixtures(Mode fixtureMode, const std::string& fixtureDirectory)
+    : mode(fixtureMode), directory(fixtureDirectory) {
+    if (mode == Record) {
+        std::error_code ec;
+        fs::create_directories(directory, ec);
+        if (ec) {
+            std::cerr << "Warning: Could not create fixture directory " << directory
+                      << ": " << ec.message() << "\n";
+        }
+    }
+}
+
+std::chrono::microseconds HttpFixtures::TransferTime(size_t bytes) const {
+    if (bandwidth == 0) {
+        return std::chrono::microseconds(0);
+    }
+    return std::chrono::microseconds(static_cast<int64_t>(bytes * 1000000.0 / bandwidth));
+}
+
+std::string HttpFixtures::Key(const std::string& url) {
+    size_t scheme = url.find("://");
+    size_t pathStart = scheme == std::string::npos ? 0 : url.find('/', scheme + 3);
+    if (pathStart == std::string::npos) {
+        return "/";
+    }
+    return url.substr(pathStart);
+}
+
+uint64_t HttpFixtures::Hash(const std::string& key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::string HttpFixtures::PathFor(const std::string& url) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.fixture", static_cast<unsigned long long>(Hash(Key(url))));
+    return (fs::path(directory) / name).string();
+}
+
+bool HttpFixtures::Save(const std::string& url, long status, const std::string& body) const {
+    std::string path = PathFor(url);
+    std::string tempPath = path + ".tmp" + std::to_string(tempCounter++);
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open " << tempPath << " for writing\n";
+            return false;
+        }
+        file << FixtureMagic << "\n"
+             << "url: " << Key(url) << "\n"
+             << "status: " << status << "\n"
+             << "length: " << body.size() << "\n\n";
+        file.write(body.data(), static_cast<std::streamsize>(body.size()));
+        if (!file) {
+            std::cerr << "Error: Failed writing fixture " << tempPath << "\n";
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error: Could not move " << tempPath << " to " << path << "\n";
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool HttpFixtures::Load(const std::string& url, long& status, std::string& body) const {
+    std::ifstream file(PathFor(url), std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != FixtureMagic) {
+        std::cerr << "Warning: " << PathFor(url) << " is not a fixture file\n";
+        return false;
+    }
+
+    std::string key;
+    long recordedStatus = 0;
+    size_t length = 0;
+    while (std::getline(file, line) && !line.empty()) {
+        size_t colon = line.find(": ");
+        if (colon == std::string::npos) continue;
+        std::string name = line.substr(0, colon);
+        std::string value = line.substr(colon + 2);
+        try {
+            if (name == "url") key = value;
+            else if (name == "status") recordedStatus = std::stol(value);
+            else if (name == "length") length = static_cast<size_t>(std::stoull(value));
+        } catch (const std::exception&) {
+            std::cerr << "Warning: Malformed fixture header in " << PathFor(url) << "\n";
+            return false;
+        }
+    }
+
+    // Guards against hash collisions
+    if (key != Key(url)) {
+        return false;
+    }
+
+    body.resize(length);
+    if (length > 0 && !file.read(&body[0], static_cast<std::streamsize>(length))) {
+        std::cerr << "Warning: Truncated fixture " << PathFor(url) << "\n";
+        return false;
+    }
+    status = recordedStatus;
+    return true;
+}
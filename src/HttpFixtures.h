@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Record/replay store for HTTP responses, used by HttpClient and
+// FetchEngine to benchmark and test the fetch paths offline.
+//
+// In Record mode every completed response (status and body) is written to
+// <directory>/<hash>.fixture. In Replay mode requests never touch the
+// network: responses are served from those files after a simulated
+// per-request latency, with the body paced at a simulated bandwidth.
+//
+// Fixtures are keyed by the URL's path and query only, so responses
+// recorded from the real API can be replayed whatever base URL the loader
+// is pointed at, and scripts/fixture_server.py can serve the same
+// directory over real HTTP.
+class HttpFixtures {
+public:
+    enum Mode { Record, Replay };
+
+    HttpFixtures(Mode mode, const std::string& directory);
+
+    Mode GetMode() const { return mode; }
+    const std::string& GetDirectory() const { return directory; }
+
+    // Replay pacing: delay before the first byte of each response, and body
+    // throughput per request (0 = unlimited)
+    void SetLatency(std::chrono::milliseconds value) { latency = value; }
+    void SetBandwidth(size_t bytesPerSecond) { bandwidth = bytesPerSecond; }
+    std::chrono::microseconds Latency() const { return latency; }
+    std::chrono::microseconds TransferTime(size_t bytes) const;
+
+    // Stores a response; safe to call from several threads
+    bool Save(const std::string& url, long status, const std::string& body) const;
+
+    // Looks up the recorded response for `url`; false if there is none
+    bool Load(const std::string& url, long& status, std::string& body) const;
+
+    // Path and query of `url` ("/v8/finance/chart/AAPL?range=1d")
+    static std::string Key(const std::string& url);
+
+    // 64-bit FNV-1a of `key`, used as the fixture file name
+    static uint64_t Hash(const std::string& key);
+
+    std::string PathFor(const std::string& url) const;
+
+private:
+    Mode mode;
+    std::string directory;
+    std::chrono::microseconds latency{0};
+    size_t bandwidth = 0;
+    mutable std::atomic<uint64_t> tempCounter{0};
+};
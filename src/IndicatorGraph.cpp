@@ -0,0 +1,188 @@
+#include "IndicatorGraph.h"
+#include <tuple>
+
+bool IndicatorKey::operator<(const IndicatorKey& other) const {
+    return std::tie(kind, period, slow, signal, width) <
+           std::tie(other.kind, other.period, other.slow, other.signal, other.width);
+}
+
+IndicatorGraph::IndicatorGraph(const PriceSeries& priceSeries) : series(priceSeries) {
+}
+
+const std::vector<double>& IndicatorGraph::Get(const IndicatorKey& key) {
+    switch (key.kind) {
+        case IndicatorKey::MACD:
+            return MACD(key.period, key.slow, key.signal).macd;
+        case IndicatorKey::MACDSignal:
+            return MACD(key.period, key.slow, key.signal).signal;
+        case IndicatorKey::MACDHistogram:
+            return MACD(key.period, key.slow, key.signal).histogram;
+        case IndicatorKey::BollingerUpper:
+            return Bollinger(key.period, key.width).upper;
+        case IndicatorKey::BollingerLower:
+            return Bollinger(key.period, key.width).lower;
+        default:
+            break;
+    }
+    auto it = lines.find(key);
+    if (it != lines.end()) {
+        return it->second;
+    }
+    return Compute(key);
+}
+
+const std::vector<double>& IndicatorGraph::Compute(const IndicatorKey& key) {
+    ++evaluations;
+    std::vector<double> values;
+    switch (key.kind) {
+        case IndicatorKey::Returns:
+            values = processor.CalculateReturns(series);
+            break;
+        case IndicatorKey::SMA:
+            values = processor.CalculateSMA(series, key.period);
+            break;
+        case IndicatorKey::EMA:
+            values = processor.CalculateEMA(series, key.period);
+            break;
+        case IndicatorKey::Volatility:
+            values.resize(DataProcessor::VolatilityLayout(series.size(), key.period).length);
+            if (!values.empty()) {
+                processor.CalculateVolatilityFromReturns(Get({IndicatorKey::Returns}), key.period, values);
+            }
+            break;
+        case IndicatorKey::RSI:
+            values = processor.CalculateRSI(series, key.period);
+            break;
+        default:
+            break;
+    }
+    return lines.emplace(key, std::move(values)).first->second;
+}
+
+const DataProcessor::MACDResult& IndicatorGraph::MACD(int fastPeriod, int slowPeriod, int signalPeriod) {
+    IndicatorKey key(IndicatorKey::MACD, fastPeriod, slowPeriod, signalPeriod);
+    auto it = macds.find(key);
+    if (it != macds.end()) {
+        return it->second;
+    }
+
+    ++evaluations;
+    DataProcessor::MACDResult result;
+    size_t length = DataProcessor::MACDLayout(series.size(), fastPeriod, slowPeriod, signalPeriod).length;
+    if (length > 0) {
+        // Same arithmetic as CalculateMACD, on the cached EMAs
+        const auto& fastEMA = Get({IndicatorKey::EMA, fastPeriod});
+        const auto& slowEMA = Get({IndicatorKey::EMA, slowPeriod});
+        result.macd.resize(length);
+        for (size_t i = 0; i < length; ++i) {
+            result.macd[i] = fastEMA[i] - slowEMA[i];
+        }
+        if (signalPeriod > 0) {
+            result.signal.resize(length);
+            processor.CalculateEMA(result.macd, signalPeriod, result.signal);
+            result.histogram.resize(length);
+            for (size_t i = 0; i < length; ++i) {
+                result.histogram[i] = result.macd[i] - result.signal[i];
+            }
+        }
+    }
+    return macds.emplace(key, std::move(result)).first->second;
+}
+
+const DataProcessor::BollingerBands& IndicatorGraph::Bollinger(int period, double stdDevMultiplier) {
+    IndicatorKey key(IndicatorKey::BollingerUpper, period, 0, 0, stdDevMultiplier);
+    auto it = bollingers.find(key);
+    if (it != bollingers.end()) {
+        return it->second;
+    }
+
+    ++evaluations;
+    DataProcessor::BollingerBands bands;
+    size_t length = DataProcessor::BollingerLayout(series.size(), period).length;
+    if (length > 0) {
+        bands.middle = Get({IndicatorKey::SMA, period});
+        bands.upper.resize(length);
+        bands.lower.resize(length);
+        processor.CalculateBollingerEnvelope(series.Closes(), bands.middle, period, stdDevMultiplier,
+                                             bands.upper, bands.lower);
+    }
+    return bollingers.emplace(key, std::move(bands)).first->second;
+}
+
+void IndicatorGraph::Prefetch(const DataProcessor::IndicatorSet& indicators) {
+    // Ask the pipeline only for what is missing
+    DataProcessor::IndicatorSet missing;
+    for (int period : indicators.smaPeriods) {
+        if (lines.count({IndicatorKey::SMA, period}) == 0) {
+            missing.smaPeriods.push_back(period);
+        }
+    }
+    for (int period : indicators.emaPeriods) {
+        if (lines.count({IndicatorKey::EMA, period}) == 0) {
+            missing.emaPeriods.push_back(period);
+        }
+    }
+    missing.returns = indicators.returns && lines.count({IndicatorKey::Returns}) == 0;
+    if (indicators.volatilityWindow > 0 &&
+        lines.count({IndicatorKey::Volatility, indicators.volatilityWindow}) == 0) {
+        missing.volatilityWindow = indicators.volatilityWindow;
+    }
+    if (indicators.rsiPeriod > 0 && lines.count({IndicatorKey::RSI, indicators.rsiPeriod}) == 0) {
+        missing.rsiPeriod = indicators.rsiPeriod;
+    }
+    if (indicators.macd && macds.count({IndicatorKey::MACD, indicators.macdFast, indicators.macdSlow,
+                                        indicators.macdSignal}) == 0) {
+        missing.macd = true;
+        missing.macdFast = indicators.macdFast;
+        missing.macdSlow = indicators.macdSlow;
+        missing.macdSignal = indicators.macdSignal;
+    }
+    if (indicators.bollingerPeriod > 0 &&
+        bollingers.count({IndicatorKey::BollingerUpper, indicators.bollingerPeriod, 0, 0,
+                          indicators.bollingerStd}) == 0) {
+        missing.bollingerPeriod = indicators.bollingerPeriod;
+        missing.bollingerStd = indicators.bollingerStd;
+    }
+
+    auto results = processor.RunIndicatorPipeline(series, missing);
+
+    auto store = [this](const IndicatorKey& key, std::vector<double>& values) {
+        if (lines.emplace(key, std::move(values)).second) {
+            ++evaluations;
+        }
+    };
+    for (size_t k = 0; k < missing.smaPeriods.size(); ++k) {
+        store({IndicatorKey::SMA, missing.smaPeriods[k]}, results.sma[k]);
+    }
+    for (size_t k = 0; k < missing.emaPeriods.size(); ++k) {
+        store({IndicatorKey::EMA, missing.emaPeriods[k]}, results.ema[k]);
+    }
+    if (missing.returns) {
+        store({IndicatorKey::Returns}, results.returns);
+    }
+    if (missing.volatilityWindow > 0) {
+        store({IndicatorKey::Volatility, missing.volatilityWindow}, results.volatility);
+    }
+    if (missing.rsiPeriod > 0) {
+        store({IndicatorKey::RSI, missing.rsiPeriod}, results.rsi);
+    }
+    if (missing.macd) {
+        macds.emplace(IndicatorKey(IndicatorKey::MACD, missing.macdFast, missing.macdSlow, missing.macdSignal),
+                      std::move(results.macd));
+        ++evaluations;
+    }
+    if (missing.bollingerPeriod > 0) {
+        // The middle band doubles as the SMA of its period
+        lines.emplace(IndicatorKey(IndicatorKey::SMA, missing.bollingerPeriod), results.bollinger.middle);
+        bollingers.emplace(IndicatorKey(IndicatorKey::BollingerUpper, missing.bollingerPeriod, 0, 0,
+                                        missing.bollingerStd),
+                           std::move(results.bollinger));
+        ++evaluations;
+    }
+}
+
+void IndicatorGraph::Clear() {
+    lines.clear();
+    macds.clear();
+    bollingers.clear();
+}
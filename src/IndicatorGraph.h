@@ -0,0 +1,82 @@
+#pragma once
+#include "DataProcessor.h"
+#include "PriceSeries.h"
+#include <cstddef>
+#include <map>
+#include <vector>
+
+// Identifies one indicator series of a price series: what it is and its
+// parameters. `period` is the SMA/EMA/RSI/Bollinger period, the volatility
+// window or the MACD fast period; `slow` and `signal` are only used by the
+// MACD kinds and `width` (the std-dev multiplier) by the Bollinger kinds.
+struct IndicatorKey {
+    enum Kind {
+        Returns, SMA, EMA, Volatility, RSI,
+        MACD, MACDSignal, MACDHistogram,
+        BollingerUpper, BollingerLower
+    };
+
+    IndicatorKey(Kind indicator, int indicatorPeriod = 0, int slowPeriod = 0, int signalPeriod = 0,
+                 double stdDevMultiplier = 0.0)
+        : kind(indicator), period(indicatorPeriod), slow(slowPeriod), signal(signalPeriod),
+          width(stdDevMultiplier) {}
+
+    Kind kind;
+    int period;
+    int slow;
+    int signal;
+    double width;
+
+    bool operator<(const IndicatorKey& other) const;
+};
+
+// Lazily evaluated, memoized indicators of one price series.
+//
+// Indicators are requested by key and computed on first use; every result
+// is cached, and indicators built from others take them from the cache
+// instead of recomputing them: volatility reads the returns, MACD the two
+// EMAs, Bollinger Bands the SMA of their period. However many reports ask
+// for an indicator, and whatever else depends on it, it is computed once
+// per graph.
+//
+//   IndicatorGraph graph(series);
+//   const auto& sma = graph.Get({IndicatorKey::SMA, 20});
+//   const auto& bands = graph.Bollinger(20, 2.0);   // reuses SMA(20)
+//
+// Results are bit-identical to the DataProcessor function for the same
+// indicator and have the same layout. The series is borrowed and must
+// outlive the graph; returned references stay valid until Clear() or the
+// graph is destroyed. Not thread-safe.
+class IndicatorGraph {
+public:
+    explicit IndicatorGraph(const PriceSeries& series);
+
+    const std::vector<double>& Get(const IndicatorKey& key);
+
+    // All three MACD lines / all three bands; the middle band is SMA(period)
+    const DataProcessor::MACDResult& MACD(int fastPeriod = 12, int slowPeriod = 26, int signalPeriod = 9);
+    const DataProcessor::BollingerBands& Bollinger(int period = 20, double stdDevMultiplier = 2.0);
+
+    // Computes everything in the set that is not cached yet with one
+    // DataProcessor::RunIndicatorPipeline pass, so a report that knows its
+    // indicators up front gets the fused pass and later Get calls are
+    // lookups
+    void Prefetch(const DataProcessor::IndicatorSet& indicators);
+
+    // Number of indicators computed since construction (cache misses),
+    // counting a MACD or Bollinger result as one
+    size_t Evaluations() const { return evaluations; }
+
+    // Drops every cached result, e.g. after the series has changed
+    void Clear();
+
+private:
+    const std::vector<double>& Compute(const IndicatorKey& key);
+
+    const PriceSeries& series;
+    DataProcessor processor;
+    std::map<IndicatorKey, std::vector<double>> lines;
+    std::map<IndicatorKey, DataProcessor::MACDResult> macds;           // keyed as MACD
+    std::map<IndicatorKey, DataProcessor::BollingerBands> bollingers;  // keyed as BollingerUpper
+    size_t evaluations = 0;
+};
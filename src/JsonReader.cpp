@@ -0,0 +1,337 @@
+#include "JsonReader.h"
+#include "CsvScan.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+inline bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+int HexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Value of a well-formed JSON number beyond the range of a double, as
+// strtod gives it: +-HUGE_VAL on overflow, a signed zero on underflow.
+// Which of the two follows from the decimal exponent of the leading
+// significant digit.
+double OutOfRangeNumber(const char* p, const char* end) {
+    bool negative = *p == '-';
+    if (negative) ++p;
+
+    long long magnitude = 0;
+    if (*p != '0') {
+        for (magnitude = -1; p < end && IsDigit(*p); ++p) ++magnitude;
+    } else if (++p < end && *p == '.') {
+        for (magnitude = -1, ++p; p < end && *p == '0'; ++p) --magnitude;
+    }
+    while (p < end && *p != 'e' && *p != 'E') ++p;
+    if (p < end) {
+        ++p;
+        bool negativeExponent = *p == '-';
+        if (*p == '+' || *p == '-') ++p;
+        long long exponent = 0;
+        for (; p < end && IsDigit(*p); ++p) {
+            exponent = std::min(exponent * 10 + (*p - '0'), 1000000000LL);
+        }
+        magnitude += negativeExponent ? -exponent : exponent;
+    }
+
+    double value = magnitude > 0 ? HUGE_VAL : 0.0;
+    return negative ? -value : value;
+}
+
+} // namespace
+
+bool JsonReader::Parse(const char* data, size_t length, JsonHandler& target) {
+    begin = cursor = data;
+    end = data + length;
+    handler = &target;
+    error.clear();
+
+    SkipWhitespace();
+    if (!ParseValue(0)) {
+        return false;
+    }
+    SkipWhitespace();
+    if (cursor != end) {
+        return Fail("unexpected data after document");
+    }
+    return true;
+}
+
+bool JsonReader::Fail(const char* message) {
+    error = std::string(message) + " at offset " + std::to_string(cursor - begin);
+    return false;
+}
+
+void JsonReader::SkipWhitespace() {
+    while (cursor < end && (*cursor == ' ' || *cursor == '\n' || *cursor == '\r' || *cursor == '\t')) {
+        ++cursor;
+    }
+}
+
+bool JsonReader::ParseValue(int depth) {
+    if (cursor >= end) {
+        return Fail("unexpected end of input");
+    }
+    switch (*cursor) {
+        case '{':
+            return ParseObject(depth + 1);
+        case '[':
+            return ParseArray(depth + 1);
+        case '"': {
+            std::string_view value;
+            if (!ParseString(value)) {
+                return false;
+            }
+            handler->String(value);
+            return true;
+        }
+        case 't':
+            if (!ParseLiteral("true", 4)) return false;
+            handler->Bool(true);
+            return true;
+        case 'f':
+            if (!ParseLiteral("false", 5)) return false;
+            handler->Bool(false);
+            return true;
+        case 'n':
+            if (!ParseLiteral("null", 4)) return false;
+            handler->Null();
+            return true;
+        default:
+            return ParseNumber();
+    }
+}
+
+bool JsonReader::ParseObject(int depth) {
+    if (depth > MaxDepth) {
+        return Fail("nesting too deep");
+    }
+    ++cursor;  // '{'
+    handler->StartObject();
+
+    SkipWhitespace();
+    if (cursor < end && *cursor == '}') {
+        ++cursor;
+        handler->EndObject();
+        return true;
+    }
+
+    for (;;) {
+        if (cursor >= end || *cursor != '"') {
+            return Fail("expected object key");
+        }
+        std::string_view key;
+        if (!ParseString(key)) {
+            return false;
+        }
+        handler->Key(key);
+
+        SkipWhitespace();
+        if (cursor >= end || *cursor != ':') {
+            return Fail("expected ':'");
+        }
+        ++cursor;
+        SkipWhitespace();
+        if (!ParseValue(depth)) {
+            return false;
+        }
+
+        SkipWhitespace();
+        if (cursor < end && *cursor == ',') {
+            ++cursor;
+            SkipWhitespace();
+        } else if (cursor < end && *cursor == '}') {
+            ++cursor;
+            handler->EndObject();
+            return true;
+        } else {
+            return Fail("expected ',' or '}'");
+        }
+    }
+}
+
+bool JsonReader::ParseArray(int depth) {
+    if (depth > MaxDepth) {
+        return Fail("nesting too deep");
+    }
+    ++cursor;  // '['
+    handler->StartArray();
+
+    SkipWhitespace();
+    if (cursor < end && *cursor == ']') {
+        ++cursor;
+        handler->EndArray();
+        return true;
+    }
+
+    for (;;) {
+        if (!ParseValue(depth)) {
+            return false;
+        }
+        SkipWhitespace();
+        if (cursor < end && *cursor == ',') {
+            ++cursor;
+            SkipWhitespace();
+        } else if (cursor < end && *cursor == ']') {
+            ++cursor;
+            handler->EndArray();
+            return true;
+        } else {
+            return Fail("expected ',' or ']'");
+        }
+    }
+}
+
+bool JsonReader::ParseString(std::string_view& value) {
+    const char* start = ++cursor;  // past the opening quote
+
+    // Fast path: no escapes, so the value is a view into the input
+    const char* quote = static_cast<const char*>(std::memchr(start, '"', end - start));
+    if (!quote) {
+        return Fail("unterminated string");
+    }
+    if (!std::memchr(start, '\\', quote - start)) {
+        value = std::string_view(start, quote - start);
+        cursor = quote + 1;
+        return true;
+    }
+
+    // Slow path: decode into the scratch buffer
+    scratch.clear();
+    while (cursor < end) {
+        char c = *cursor++;
+        if (c == '"') {
+            value = std::string_view(scratch);
+            return true;
+        }
+        if (c != '\\') {
+            scratch.push_back(c);
+            continue;
+        }
+        if (cursor >= end) {
+            break;
+        }
+        char escape = *cursor++;
+        switch (escape) {
+            case '"':  scratch.push_back('"'); break;
+            case '\\': scratch.push_back('\\'); break;
+            case '/':  scratch.push_back('/'); break;
+            case 'b':  scratch.push_back('\b'); break;
+            case 'f':  scratch.push_back('\f'); break;
+            case 'n':  scratch.push_back('\n'); break;
+            case 'r':  scratch.push_back('\r'); break;
+            case 't':  scratch.push_back('\t'); break;
+            case 'u': {
+                unsigned codePoint = 0;
+                for (int i = 0; i < 4; ++i) {
+                    int digit = cursor < end ? HexValue(*cursor) : -1;
+                    if (digit < 0) {
+                        return Fail("invalid \\u escape");
+                    }
+                    codePoint = codePoint * 16 + static_cast<unsigned>(digit);
+                    ++cursor;
+                }
+                if (!AppendCodePoint(codePoint)) {
+                    return false;
+                }
+                break;
+            }
+            default:
+                return Fail("invalid escape");
+        }
+    }
+    return Fail("unterminated string");
+}
+
+bool JsonReader::AppendCodePoint(unsigned codePoint) {
+    // A high surrogate must be followed by an escaped low surrogate
+    if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+        if (end - cursor < 6 || cursor[0] != '\\' || cursor[1] != 'u') {
+            return Fail("unpaired surrogate");
+        }
+        unsigned low = 0;
+        for (int i = 2; i < 6; ++i) {
+            int digit = HexValue(cursor[i]);
+            if (digit < 0) {
+                return Fail("invalid \\u escape");
+            }
+            low = low * 16 + static_cast<unsigned>(digit);
+        }
+        if (low < 0xDC00 || low > 0xDFFF) {
+            return Fail("unpaired surrogate");
+        }
+        cursor += 6;
+        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+    } else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+        return Fail("unpaired surrogate");
+    }
+
+    if (codePoint < 0x80) {
+        scratch.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        scratch.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        scratch.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        scratch.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        scratch.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        scratch.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        scratch.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        scratch.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        scratch.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        scratch.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+    return true;
+}
+
+bool JsonReader::ParseNumber() {
+    // Validate the JSON number grammar, then convert exactly that span
+    const char* start = cursor;
+    const char* p = cursor;
+    if (p < end && *p == '-') ++p;
+    if (p < end && *p == '0') {
+        ++p;
+    } else if (p < end && IsDigit(*p)) {
+        while (p < end && IsDigit(*p)) ++p;
+    } else {
+        return Fail("unexpected character");
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        if (p >= end || !IsDigit(*p)) return Fail("invalid number");
+        while (p < end && IsDigit(*p)) ++p;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        if (p < end && (*p == '+' || *p == '-')) ++p;
+        if (p >= end || !IsDigit(*p)) return Fail("invalid number");
+        while (p < end && IsDigit(*p)) ++p;
+    }
+
+    // The span is a valid number, so a failed conversion means it is out
+    // of range; that saturates instead of failing the document
+    double value = 0.0;
+    if (!CsvScan::ParseDouble(start, p, value)) {
+        value = OutOfRangeNumber(start, p);
+    }
+    cursor = p;
+    handler->Number(value);
+    return true;
+}
+
+bool JsonReader::ParseLiteral(const char* literal, size_t length) {
+    if (static_cast<size_t>(end - cursor) < length || std::memcmp(cursor, literal, length) != 0) {
+        return Fail("invalid literal");
+    }
+    cursor += length;
+    return true;
+}
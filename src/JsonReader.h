@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Receives events from JsonReader in document order. String and key views
+// point into the input, or into the reader's scratch buffer when escapes
+// had to be decoded, and are only valid for the duration of the call.
+class JsonHandler {
+public:
+    virtual ~JsonHandler() = default;
+
+    virtual void StartObject() {}
+    virtual void EndObject() {}
+    virtual void StartArray() {}
+    virtual void EndArray() {}
+    virtual void Key(std::string_view) {}
+    virtual void String(std::string_view) {}
+    virtual void Number(double) {}
+    virtual void Bool(bool) {}
+    virtual void Null() {}
+};
+
+// Single-pass, SAX-style JSON parser. Walks the document once and reports
+// each value to a JsonHandler without building a tree; the only allocation
+// is a scratch buffer reused for strings containing escapes. Numbers are
+// converted with CsvScan::ParseDouble; one beyond a double's range becomes
+// +-HUGE_VAL or zero, as with strtod.
+class JsonReader {
+public:
+    // Returns false on malformed input (events up to the error have
+    // already been delivered); Error() then describes the problem
+    bool Parse(const char* data, size_t length, JsonHandler& handler);
+    bool Parse(const std::string& text, JsonHandler& handler) {
+        return Parse(text.data(), text.size(), handler);
+    }
+
+    const std::string& Error() const { return error; }
+
+private:
+    static const int MaxDepth = 256;
+
+    bool ParseValue(int depth);
+    bool ParseObject(int depth);
+    bool ParseArray(int depth);
+    bool ParseString(std::string_view& value);
+    bool ParseNumber();
+    bool ParseLiteral(const char* literal, size_t length);
+    bool AppendCodePoint(unsigned codePoint);
+    void SkipWhitespace();
+    bool Fail(const char* message);
+
+    const char* cursor = nullptr;
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    JsonHandler* handler = nullptr;
+    std::string scratch;
+    std::string error;
+};
@@ -0,0 +1,72 @@
+#include "Panel.h"
+#include <algorithm>
+#include <bitset>
+#include <limits>
+
+Panel::Panel(std::vector<std::string> tickerNames, std::vector<int32_t> dateAxis, Layout storage)
+    : tickers(std::move(tickerNames)), dates(std::move(dateAxis)), layout(storage) {
+    constexpr size_t perLine = Alignment / sizeof(double);
+    size_t inner = layout == Layout::ColumnMajor ? dates.size() : tickers.size();
+    size_t outer = layout == Layout::ColumnMajor ? tickers.size() : dates.size();
+    leading = (inner + perLine - 1) / perLine * perLine;
+    values.assign(leading * outer, std::numeric_limits<double>::quiet_NaN());
+    validity.assign((tickers.size() * dates.size() + 63) / 64, 0);
+}
+
+void Panel::Set(size_t date, size_t ticker, double value) {
+    values[Offset(date, ticker)] = value;
+    SetValid(date, ticker);
+}
+
+size_t Panel::ValidCount() const {
+    size_t count = 0;
+    for (uint64_t word : validity) {
+        count += std::bitset<64>(word).count();
+    }
+    return count;
+}
+
+StridedSpan<const double> Panel::Column(size_t ticker) const {
+    return StridedSpan<const double>(values.data() + Offset(0, ticker), dates.size(),
+                                     layout == Layout::ColumnMajor ? 1 : leading);
+}
+
+StridedSpan<double> Panel::Column(size_t ticker) {
+    return StridedSpan<double>(values.data() + Offset(0, ticker), dates.size(),
+                               layout == Layout::ColumnMajor ? 1 : leading);
+}
+
+StridedSpan<const double> Panel::Row(size_t date) const {
+    return StridedSpan<const double>(values.data() + Offset(date, 0), tickers.size(),
+                                     layout == Layout::RowMajor ? 1 : leading);
+}
+
+StridedSpan<double> Panel::Row(size_t date) {
+    return StridedSpan<double>(values.data() + Offset(date, 0), tickers.size(),
+                               layout == Layout::RowMajor ? 1 : leading);
+}
+
+Panel Panel::WithLayout(Layout storage) const {
+    if (storage == layout) {
+        return *this;
+    }
+    Panel result(tickers, dates, storage);
+    result.validity = validity;
+
+    // Tiles of 32 x 32 cells keep both the reads and the writes in cache
+    constexpr size_t Block = 32;
+    size_t inner = layout == Layout::ColumnMajor ? dates.size() : tickers.size();
+    size_t outer = layout == Layout::ColumnMajor ? tickers.size() : dates.size();
+    for (size_t o = 0; o < outer; o += Block) {
+        for (size_t i = 0; i < inner; i += Block) {
+            size_t outerEnd = std::min(outer, o + Block);
+            size_t innerEnd = std::min(inner, i + Block);
+            for (size_t a = o; a < outerEnd; ++a) {
+                for (size_t b = i; b < innerEnd; ++b) {
+                    result.values[b * result.leading + a] = values[a * leading + b];
+                }
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include "Span.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+
+// Allocator for storage aligned to a cache line (and an AVX-512 vector)
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, size_t) { ::operator delete(p, std::align_val_t(Alignment)); }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+// Non-owning view of `count` values `stride` apart: a ticker or a date of
+// a Panel, contiguous (stride 1) when it matches the panel's layout
+template <typename T>
+class StridedSpan {
+public:
+    StridedSpan(T* first, size_t n, size_t spacing) : ptr(first), count(n), step(spacing) {}
+
+    T* data() const { return ptr; }
+    size_t size() const { return count; }
+    size_t stride() const { return step; }
+    bool IsContiguous() const { return step == 1; }
+    T& operator[](size_t i) const { return ptr[i * step]; }
+
+    // The values as a Span; empty unless the view is contiguous
+    Span<T> Contiguous() const { return Span<T>(ptr, step == 1 ? count : 0); }
+
+private:
+    T* ptr;
+    size_t count;
+    size_t step;
+};
+
+// Values of many tickers on one date axis: a dates x tickers matrix in one
+// 64-byte aligned block, with a validity bitmap for cells that have no
+// value (those hold NaN).
+//
+// ColumnMajor keeps each ticker's history contiguous, which is what
+// per-series work wants (returns, covariance, PCA); RowMajor keeps each
+// date's cross-section contiguous, for work across tickers (ranking,
+// writing one line per date). WithLayout converts between the two. The
+// leading dimension is padded so that every column (or row) starts on a
+// 64-byte boundary.
+//
+//   Panel returns = processor.CalculateAlignedReturns(series, tickers);
+//   Span<const double> aapl = returns.Column(0).Contiguous();
+//   Panel byDate = returns.WithLayout(Panel::Layout::RowMajor);
+//   StridedSpan<const double> cross = byDate.Row(d);   // every ticker on date d
+class Panel {
+public:
+    enum class Layout { ColumnMajor, RowMajor };
+    static constexpr size_t Alignment = 64;
+
+    Panel() = default;
+    // Every cell starts out invalid (NaN)
+    Panel(std::vector<std::string> tickerNames, std::vector<int32_t> dateAxis,
+          Layout storage = Layout::ColumnMajor);
+
+    size_t Tickers() const { return tickers.size(); }
+    size_t Dates() const { return dates.size(); }
+    bool empty() const { return tickers.empty() || dates.empty(); }
+    const std::vector<std::string>& TickerNames() const { return tickers; }
+    const std::vector<int32_t>& DateAxis() const { return dates; }  // days since 1970-01-01, ascending
+    Layout StorageLayout() const { return layout; }
+
+    double Value(size_t date, size_t ticker) const { return values[Offset(date, ticker)]; }
+    bool IsValid(size_t date, size_t ticker) const {
+        size_t bit = ticker * dates.size() + date;
+        return (validity[bit / 64] >> (bit % 64)) & 1;
+    }
+    // Stores a value and marks the cell valid
+    void Set(size_t date, size_t ticker, double value);
+    // Marks a cell valid after writing it through a view
+    void SetValid(size_t date, size_t ticker) {
+        size_t bit = ticker * dates.size() + date;
+        validity[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+    size_t ValidCount() const;
+
+    // One ticker across all dates / one date across all tickers
+    StridedSpan<const double> Column(size_t ticker) const;
+    StridedSpan<double> Column(size_t ticker);
+    StridedSpan<const double> Row(size_t date) const;
+    StridedSpan<double> Row(size_t date);
+
+    // Same cells in the other layout (a blocked transpose), or a copy
+    Panel WithLayout(Layout storage) const;
+
+private:
+    size_t Offset(size_t date, size_t ticker) const {
+        return layout == Layout::ColumnMajor ? ticker * leading + date : date * leading + ticker;
+    }
+
+    std::vector<std::string> tickers;
+    std::vector<int32_t> dates;
+    Layout layout = Layout::ColumnMajor;
+    size_t leading = 0;  // padded length of a column (ColumnMajor) or row (RowMajor)
+    std::vector<double, AlignedAllocator<double, Alignment>> values;
+    std::vector<uint64_t> validity;  // bit ticker * Dates() + date, whatever the layout
+};
@@ -0,0 +1,84 @@
+#include "PanelBuilder.h"
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <utility>
+
+void PanelBuilder::Add(const PriceSeries& added, const std::string& ticker) {
+    series.push_back(&added);
+    tickers.push_back(ticker);
+}
+
+std::vector<int32_t> PanelBuilder::MergeDates() const {
+    using Entry = std::pair<int32_t, size_t>;  // next date, series
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    std::vector<size_t> cursor(series.size(), 0);
+    for (size_t s = 0; s < series.size(); ++s) {
+        if (!series[s]->empty()) {
+            heap.push({series[s]->date[0], s});
+        }
+    }
+
+    std::vector<int32_t> dates;
+    while (!heap.empty()) {
+        int32_t date = heap.top().first;
+        size_t present = 0;
+        while (!heap.empty() && heap.top().first == date) {
+            size_t s = heap.top().second;
+            heap.pop();
+            ++present;
+            const int32_t* seriesDates = series[s]->date.data();
+            size_t count = series[s]->date.size();
+            while (cursor[s] < count && seriesDates[cursor[s]] == date) {
+                ++cursor[s];
+            }
+            if (cursor[s] < count) {
+                heap.push({seriesDates[cursor[s]], s});
+            }
+        }
+        if (policy != JoinPolicy::Inner || present == series.size()) {
+            dates.push_back(date);
+        }
+    }
+    return dates;
+}
+
+Panel PanelBuilder::Build(Field field) const {
+    for (size_t s = 0; s < series.size(); ++s) {
+        const Column<int32_t>& dates = series[s]->date;
+        for (size_t i = 1; i < dates.size(); ++i) {
+            if (dates[i] < dates[i - 1]) {
+                std::cerr << "Error: Series " << (tickers[s].empty() ? std::to_string(s) : tickers[s])
+                          << " is not in date order\n";
+                return Panel();
+            }
+        }
+    }
+
+    Panel panel(tickers, MergeDates());
+    const std::vector<int32_t>& axis = panel.DateAxis();
+    for (size_t s = 0; s < series.size(); ++s) {
+        const Column<int32_t>& dates = series[s]->date;
+        const Column<double>& values = series[s]->*field;
+        double* column = panel.Column(s).data();
+        size_t bar = 0;
+        bool seen = false;
+        double last = 0.0;
+        for (size_t d = 0; d < axis.size(); ++d) {
+            // Bars up to this date; the last one is the cell's value
+            // (or, when it is older, the value to carry forward)
+            bool present = false;
+            while (bar < dates.size() && dates[bar] <= axis[d]) {
+                present = dates[bar] == axis[d];
+                last = values[bar];
+                seen = true;
+                ++bar;
+            }
+            if (present || (policy == JoinPolicy::ForwardFill && seen)) {
+                column[d] = last;
+                panel.SetValid(d, s);
+            }
+        }
+    }
+    return panel;
+}
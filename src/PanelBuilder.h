@@ -0,0 +1,46 @@
+#pragma once
+#include "Panel.h"
+#include "PriceSeries.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Which dates a panel keeps and what fills the gaps
+enum class JoinPolicy {
+    Inner,        // only dates every series has; every cell is valid
+    Outer,        // every date any series has; missing cells are invalid
+    ForwardFill   // as Outer, but a missing cell repeats the ticker's last
+                  // value; cells before its first bar stay invalid
+};
+
+// Joins series on their dates into a column-major Panel. The date axis
+// comes from a k-way merge of the series (a min-heap keyed on each
+// series' next date), O(total bars * log N); each ticker's column is then
+// filled by one linear walk of its series. Series must be in ascending
+// date order; if a date repeats within a series its last bar wins.
+//
+//   PanelBuilder builder(JoinPolicy::Inner);
+//   for (size_t i = 0; i < series.size(); ++i) builder.Add(series[i], tickers[i]);
+//   Panel panel = builder.Build();
+//
+// Series are borrowed and must outlive Build.
+class PanelBuilder {
+public:
+    using Field = Column<double> PriceSeries::*;
+
+    explicit PanelBuilder(JoinPolicy joinPolicy = JoinPolicy::Inner) : policy(joinPolicy) {}
+
+    void Add(const PriceSeries& series, const std::string& ticker = std::string());
+
+    // Panel of `field` (the closes by default). Returns an empty panel,
+    // with a message on stderr, if a series is out of date order.
+    Panel Build(Field field = &PriceSeries::close) const;
+
+private:
+    std::vector<int32_t> MergeDates() const;
+
+    JoinPolicy policy;
+    std::vector<const PriceSeries*> series;
+    std::vector<std::string> tickers;
+};
@@ -0,0 +1,48 @@
+#include "PriceSeries.h"
+
+PriceSeries::PriceSeries(const std::vector<StockData>& rows) {
+    reserve(rows.size());
+    for (const auto& row : rows) {
+        push_back(row);
+    }
+}
+
+void PriceSeries::reserve(size_t n) {
+    date.reserve(n);
+    open.reserve(n);
+    high.reserve(n);
+    low.reserve(n);
+    close.reserve(n);
+    volume.reserve(n);
+}
+
+void PriceSeries::clear() {
+    date.clear();
+    open.clear();
+    high.clear();
+    low.clear();
+    close.clear();
+    volume.clear();
+}
+
+void PriceSeries::push_back(const StockData& row) {
+    date.push_back(row.date);
+    open.push_back(row.open);
+    high.push_back(row.high);
+    low.push_back(row.low);
+    close.push_back(row.close);
+    volume.push_back(row.volume);
+}
+
+StockData PriceSeries::Row(size_t i) const {
+    return { date[i], open[i], high[i], low[i], close[i], volume[i] };
+}
+
+std::vector<StockData> PriceSeries::ToRows() const {
+    std::vector<StockData> rows;
+    rows.reserve(size());
+    for (size_t i = 0; i < size(); ++i) {
+        rows.push_back(Row(i));
+    }
+    return rows;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "StockData.h"
+#include "Span.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Contiguous column of values. A column either owns its storage or borrows
+// a read-only range kept alive by `owner` (e.g. a memory-mapped
+// ColumnStore file). Borrowed columns are copied on the first write, so
+// zero-copy views can flow through code that only reads them.
+template <typename T>
+class Column {
+public:
+    Column() = default;
+
+    static Column Borrow(const T* values, size_t count, std::shared_ptr<const void> owner) {
+        Column column;
+        column.borrowedData = values;
+        column.borrowedSize = count;
+        column.owner = std::move(owner);
+        return column;
+    }
+
+    bool IsBorrowed() const { return owner != nullptr; }
+
+    const T* data() const { return IsBorrowed() ? borrowedData : values.data(); }
+    size_t size() const { return IsBorrowed() ? borrowedSize : values.size(); }
+    bool empty() const { return size() == 0; }
+
+    const T& operator[](size_t i) const { return data()[i]; }
+    const T& front() const { return data()[0]; }
+    const T& back() const { return data()[size() - 1]; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size(); }
+
+    void reserve(size_t n) { MakeOwned(); values.reserve(n); }
+    void push_back(const T& value) { MakeOwned(); values.push_back(value); }
+    void clear() {
+        owner.reset();
+        borrowedData = nullptr;
+        borrowedSize = 0;
+        values.clear();
+    }
+
+private:
+    void MakeOwned() {
+        if (!IsBorrowed()) return;
+        values.assign(borrowedData, borrowedData + borrowedSize);
+        owner.reset();
+        borrowedData = nullptr;
+        borrowedSize = 0;
+    }
+
+    std::vector<T> values;
+    const T* borrowedData = nullptr;
+    size_t borrowedSize = 0;
+    std::shared_ptr<const void> owner;
+};
+
+// Column-oriented (structure-of-arrays) price history.
+// Each StockData field lives in its own contiguous column, so indicators
+// that only read closes walk 8 bytes per bar instead of a whole row.
+struct PriceSeries {
+    Column<int32_t> date;  // days since 1970-01-01
+    Column<double> open;
+    Column<double> high;
+    Column<double> low;
+    Column<double> close;
+    Column<double> volume;
+
+    PriceSeries() = default;
+
+    // Adapter for the row-oriented API: lets a std::vector<StockData> be
+    // passed anywhere a PriceSeries is expected.
+    PriceSeries(const std::vector<StockData>& rows);
+
+    size_t size() const { return close.size(); }
+    bool empty() const { return close.empty(); }
+
+    // The closes as a view, for the span overloads of DataProcessor
+    Span<const double> Closes() const { return Span<const double>(close.data(), close.size()); }
+
+    void reserve(size_t n);
+    void clear();
+    void push_back(const StockData& row);
+
+    // Row access for code that still thinks in StockData
+    StockData Row(size_t i) const;
+    std::vector<StockData> ToRows() const;
+};
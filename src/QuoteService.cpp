@@ -0,0 +1,146 @@
+#include "QuoteService.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+
+// The API echoes symbols in upper case whatever case they were asked in
+static std::string UpperCase(std::string symbol) {
+    for (char& c : symbol) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return symbol;
+}
+
+QuoteService::QuoteService(StockDataLoader& quoteLoader, std::chrono::milliseconds cacheTTL,
+                           std::chrono::milliseconds staleLimit, size_t batchSize)
+    : loader(quoteLoader),
+      symbolsPerRequest(batchSize),
+      ttl(cacheTTL),
+      maxStaleness(std::max(staleLimit, cacheTTL)) {
+}
+
+void QuoteService::SetTTL(std::chrono::milliseconds value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ttl = value;
+    maxStaleness = std::max(maxStaleness, ttl);
+}
+
+void QuoteService::SetMaxStaleness(std::chrono::milliseconds value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maxStaleness = std::max(value, ttl);
+}
+
+void QuoteService::Invalidate(const std::string& ticker) {
+    std::lock_guard<std::mutex> lock(mutex);
+    cache.erase(ticker);
+}
+
+void QuoteService::Clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    cache.clear();
+}
+
+size_t QuoteService::UpstreamRequests() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return upstreamRequests;
+}
+
+size_t QuoteService::TickersFetched() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return tickersFetched;
+}
+
+LiveQuote QuoteService::GetQuote(const std::string& ticker) {
+    return GetQuotes({ticker}).front();
+}
+
+std::vector<LiveQuote> QuoteService::GetQuotes(const std::vector<std::string>& tickers) {
+    std::vector<LiveQuote> results(tickers.size());
+    std::vector<std::pair<size_t, std::shared_future<LiveQuote>>> waiting;
+    std::vector<std::string> toFetch;
+    std::vector<std::promise<LiveQuote>> promises;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Clock::time_point now = Clock::now();
+        for (size_t i = 0; i < tickers.size(); ++i) {
+            const std::string& ticker = tickers[i];
+            auto cached = cache.find(ticker);
+            // A failed refresh re-arms the TTL on the stale copy, so an
+            // outage costs one upstream attempt per TTL, not one per caller
+            if (cached != cache.end() && now - cached->second.checkedAt < ttl &&
+                now - cached->second.fetchedAt < maxStaleness) {
+                results[i] = cached->second.quote;
+                continue;
+            }
+
+            // Join a fetch already under way (possibly one started for an
+            // earlier duplicate in this same call)
+            auto pending = inFlight.find(ticker);
+            if (pending == inFlight.end()) {
+                promises.emplace_back();
+                pending = inFlight.emplace(ticker, promises.back().get_future().share()).first;
+                toFetch.push_back(ticker);
+            }
+            waiting.emplace_back(i, pending->second);
+        }
+    }
+
+    if (!toFetch.empty()) {
+        Refresh(toFetch, promises);
+    }
+
+    for (auto& entry : waiting) {
+        results[entry.first] = entry.second.get();
+    }
+    return results;
+}
+
+void QuoteService::Refresh(const std::vector<std::string>& tickers,
+                           std::vector<std::promise<LiveQuote>>& promises) {
+    std::vector<LiveQuote> fetched;
+    try {
+        fetched = loader.FetchQuoteBatch(tickers, symbolsPerRequest);
+    } catch (const std::exception& e) {
+        // Every waiter must still be released below
+        std::cerr << "Error refreshing quotes: " << e.what() << "\n";
+    }
+
+    std::unordered_map<std::string, LiveQuote*> byTicker;
+    for (auto& quote : fetched) {
+        byTicker[UpperCase(quote.ticker)] = &quote;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t batch = symbolsPerRequest == 0 ? tickers.size() : symbolsPerRequest;
+    upstreamRequests += (tickers.size() + batch - 1) / batch;
+    tickersFetched += tickers.size();
+
+    Clock::time_point now = Clock::now();
+    for (size_t i = 0; i < tickers.size(); ++i) {
+        const std::string& ticker = tickers[i];
+        LiveQuote quote{};
+        quote.ticker = ticker;
+
+        auto found = byTicker.find(UpperCase(ticker));
+        auto cached = cache.find(ticker);
+        if (found != byTicker.end()) {
+            quote = *found->second;
+            quote.ticker = ticker;
+            cache[ticker] = CacheEntry{quote, now, now};
+        } else if (cached != cache.end() && now - cached->second.fetchedAt < maxStaleness &&
+                   !cached->second.quote.lastUpdate.empty()) {
+            // Refresh failed: serve the stale copy; fetchedAt is kept so
+            // it still ages out after maxStaleness
+            quote = cached->second.quote;
+            cached->second.checkedAt = now;
+        } else {
+            // Remember the miss for one TTL so unknown symbols are not
+            // re-requested on every call
+            cache[ticker] = CacheEntry{quote, now, now};
+        }
+
+        inFlight.erase(ticker);
+        promises[i].set_value(quote);
+    }
+}
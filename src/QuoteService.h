@@ -0,0 +1,70 @@
+#pragma once
+#include "StockDataLoader.h"
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Caching front end for live quotes, meant to sit between many viewers and
+// the quote API. Quotes younger than the TTL are served from memory;
+// everything else is refreshed through StockDataLoader::FetchQuoteBatch,
+// so one upstream request covers many symbols. Concurrent requests for a
+// ticker that is already being fetched wait for that fetch instead of
+// starting another, which keeps upstream traffic proportional to distinct
+// tickers per TTL window rather than to callers.
+class QuoteService {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // `ttl`: how long a quote is served without refreshing.
+    // `maxStaleness`: how old a cached quote may be and still be served
+    // when a refresh fails (never less than `ttl`).
+    explicit QuoteService(StockDataLoader& loader,
+                          std::chrono::milliseconds ttl = std::chrono::seconds(15),
+                          std::chrono::milliseconds maxStaleness = std::chrono::minutes(5),
+                          size_t symbolsPerRequest = 50);
+
+    QuoteService(const QuoteService&) = delete;
+    QuoteService& operator=(const QuoteService&) = delete;
+
+    // Quotes in input order. A ticker with no data (unknown symbol, or a
+    // failed fetch with nothing cached) comes back with only `ticker` set
+    // and an empty `lastUpdate`.
+    std::vector<LiveQuote> GetQuotes(const std::vector<std::string>& tickers);
+    LiveQuote GetQuote(const std::string& ticker);
+
+    void SetTTL(std::chrono::milliseconds value);
+    void SetMaxStaleness(std::chrono::milliseconds value);
+
+    // Drops cached quotes; in-flight fetches are unaffected
+    void Invalidate(const std::string& ticker);
+    void Clear();
+
+    // Upstream requests issued and tickers fetched so far
+    size_t UpstreamRequests() const;
+    size_t TickersFetched() const;
+
+private:
+    struct CacheEntry {
+        LiveQuote quote;
+        Clock::time_point fetchedAt;  // when `quote` came from upstream
+        Clock::time_point checkedAt;  // last upstream attempt, failed or not
+    };
+
+    void Refresh(const std::vector<std::string>& tickers,
+                 std::vector<std::promise<LiveQuote>>& promises);
+
+    StockDataLoader& loader;
+    size_t symbolsPerRequest;
+
+    mutable std::mutex mutex;
+    std::chrono::milliseconds ttl;
+    std::chrono::milliseconds maxStaleness;
+    std::unordered_map<std::string, CacheEntry> cache;
+    std::unordered_map<std::string, std::shared_future<LiveQuote>> inFlight;
+    size_t upstreamRequests = 0;
+    size_t tickersFetched = 0;
+};
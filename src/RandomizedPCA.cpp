@@ -0,0 +1,148 @@
+#include "RandomizedPCA.h"
+#include "SimdKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+namespace {
+
+// Orthonormalizes `vectors` in place (Gram-Schmidt, applied twice for
+// stability). Vectors that turn out linearly dependent are zeroed.
+void Orthonormalize(std::vector<std::vector<double>>& vectors) {
+    for (size_t j = 0; j < vectors.size(); ++j) {
+        std::vector<double>& v = vectors[j];
+        for (int pass = 0; pass < 2; ++pass) {
+            for (size_t i = 0; i < j; ++i) {
+                const std::vector<double>& u = vectors[i];
+                double dot = SimdKernels::SumCrossDeviations(u.data(), v.data(), v.size(), 0.0, 0.0);
+                for (size_t t = 0; t < v.size(); ++t) {
+                    v[t] -= dot * u[t];
+                }
+            }
+        }
+        double norm = std::sqrt(SimdKernels::SumSquaredDeviations(v.data(), v.size(), 0.0));
+        double scale = norm > 1e-300 ? 1.0 / norm : 0.0;
+        for (double& x : v) {
+            x *= scale;
+        }
+    }
+}
+
+// out[j] = C^T q_j: sum over tickers i of q_j[i] * (series i - means[i])
+void ProjectOntoSamples(const Panel& series, const std::vector<double>& means,
+                        const std::vector<std::vector<double>>& q, std::vector<std::vector<double>>& out) {
+    const size_t samples = series.Dates();
+    for (size_t j = 0; j < q.size(); ++j) {
+        out[j].assign(samples, 0.0);
+        double* target = out[j].data();
+        for (size_t i = 0; i < series.Tickers(); ++i) {
+            double weight = q[j][i];
+            const double* row = series.Column(i).data();
+            double mean = means[i];
+            for (size_t t = 0; t < samples; ++t) {
+                target[t] += weight * (row[t] - mean);
+            }
+        }
+    }
+}
+
+// out[j][i] = (series i - means[i]) . z_j, i.e. out[j] = C z_j
+void ProjectOntoVariables(const Panel& series, const std::vector<double>& means,
+                          const std::vector<std::vector<double>>& z, std::vector<std::vector<double>>& out) {
+    const size_t samples = series.Dates();
+    for (size_t j = 0; j < z.size(); ++j) {
+        out[j].resize(series.Tickers());
+        for (size_t i = 0; i < series.Tickers(); ++i) {
+            out[j][i] = SimdKernels::SumCrossDeviations(series.Column(i).data(), z[j].data(), samples,
+                                                        means[i], 0.0);
+        }
+    }
+}
+
+} // namespace
+
+SymmetricEigenResult RandomizedPCA(const Panel& series, size_t components, const RandomizedPCAOptions& options) {
+    SymmetricEigenResult result;
+    if (series.StorageLayout() != Panel::Layout::ColumnMajor) {
+        return RandomizedPCA(series.WithLayout(Panel::Layout::ColumnMajor), components, options);
+    }
+    if (series.Tickers() == 0 || components == 0) {
+        result.success = true;
+        return result;
+    }
+    const size_t variables = series.Tickers();
+    const size_t samples = series.Dates();
+    if (series.ValidCount() != variables * samples) {
+        std::cerr << "Error: Randomized PCA needs a panel without missing values\n";
+        return result;
+    }
+    if (samples < 2) {
+        std::cerr << "Error: Randomized PCA needs at least two samples\n";
+        return result;
+    }
+    components = std::min(components, variables);
+    const size_t sketch = std::min(variables, components + options.oversampling);
+
+    std::vector<double> means(variables);
+    for (size_t i = 0; i < variables; ++i) {
+        means[i] = SimdKernels::Sum(series.Column(i).data(), samples) / samples;
+    }
+
+    // Range finder: Q spans C * Omega for a Gaussian Omega (samples x sketch),
+    // refined by power iterations Q <- orth(C C^T Q). Vectors are stored as
+    // rows: q[j] is column j of Q (length = variables), z[j] likewise.
+    std::mt19937_64 generator(options.seed);
+    std::normal_distribution<double> gaussian;
+    std::vector<std::vector<double>> z(sketch, std::vector<double>(samples));
+    for (auto& column : z) {
+        for (double& x : column) {
+            x = gaussian(generator);
+        }
+    }
+    std::vector<std::vector<double>> q(sketch);
+    ProjectOntoVariables(series, means, z, q);
+    Orthonormalize(q);
+    for (int iteration = 0; iteration < options.powerIterations; ++iteration) {
+        ProjectOntoSamples(series, means, q, z);
+        Orthonormalize(z);
+        ProjectOntoVariables(series, means, z, q);
+        Orthonormalize(q);
+    }
+
+    // Small problem: B = Q^T C (sketch x samples); the eigenvectors of
+    // B B^T, mapped back through Q, are the leading ones of C C^T
+    std::vector<std::vector<double>>& b = z;
+    ProjectOntoSamples(series, means, q, b);
+    std::vector<std::vector<double>> gram(sketch, std::vector<double>(sketch));
+    for (size_t r = 0; r < sketch; ++r) {
+        for (size_t c = 0; c <= r; ++c) {
+            gram[r][c] = gram[c][r] = SimdKernels::SumCrossDeviations(b[r].data(), b[c].data(), samples, 0.0, 0.0);
+        }
+    }
+    SymmetricEigenResult small = SymmetricEigen(gram);
+    if (!small.success) {
+        return result;
+    }
+
+    for (size_t k = 0; k < components; ++k) {
+        std::vector<double> vector(variables, 0.0);
+        for (size_t r = 0; r < sketch; ++r) {
+            double weight = small.vectors[k][r];
+            for (size_t i = 0; i < variables; ++i) {
+                vector[i] += weight * q[r][i];
+            }
+        }
+        auto largest = std::max_element(vector.begin(), vector.end(),
+                                        [](double lhs, double rhs) { return std::fabs(lhs) < std::fabs(rhs); });
+        if (*largest < 0) {
+            for (double& x : vector) {
+                x = -x;
+            }
+        }
+        result.values.push_back(std::max(0.0, small.values[k]) / (samples - 1));
+        result.vectors.push_back(std::move(vector));
+    }
+    result.success = true;
+    return result;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "Panel.h"
+#include "SymmetricEigen.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Top-k principal components by randomized range finding (Halko, Martinsson
+// and Tropp), for universes too large for a full eigen-decomposition.
+//
+// `series` holds one column per variable (a stock's returns over m dates)
+// and must have no invalid cells. The columns are centered on the fly and
+// the covariance matrix is never formed: a Gaussian sketch of its range is
+// refined with a few power iterations, orthonormalized, and the small
+// projected problem is solved exactly with SymmetricEigen. Cost is
+// O(n * m * (k + oversampling)) per pass instead of O(n^2 * m + n^3).
+// Accurate when the top k stand out from the rest, as market and sector
+// factors do; on a flat, noise-like spectrum the components found are
+// only approximate.
+struct RandomizedPCAOptions {
+    size_t oversampling = 10;   // extra sketch columns beyond k
+    int powerIterations = 2;    // sharpens the spectrum when it decays slowly
+    uint64_t seed = 0x5eed;     // fixed, so results are reproducible
+};
+
+// Returns the k largest eigenvalues of the sample covariance of the
+// columns (largest first) and their unit eigenvectors, one entry per
+// ticker, with the same sign convention as SymmetricEigen. Fails (with a
+// message on stderr) for a panel with gaps or fewer than two dates.
+SymmetricEigenResult RandomizedPCA(const Panel& series, size_t components,
+                                   const RandomizedPCAOptions& options = RandomizedPCAOptions());
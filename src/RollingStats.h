@@ -0,0 +1,107 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// One Neumaier step: adds `value` to `sum`, collecting the rounding error
+// in `compensation`. The running sums behind the SMAs use this so that
+// adding and removing prices over a long series does not drift.
+inline void CompensatedAdd(double& sum, double& compensation, double value) {
+    double t = sum + value;
+    // Selects rather than branches: which operand is larger is a coin toss
+    // for a window sum that adds and removes prices
+    bool sumLarger = std::fabs(sum) >= std::fabs(value);
+    double larger = sumLarger ? sum : value;
+    double smaller = sumLarger ? value : sum;
+    compensation += (larger - t) + smaller;
+    sum = t;
+}
+
+// Running mean and population variance over a sliding window, updated in
+// O(1) per value with Welford's recurrence instead of re-scanning the
+// window. Add grows the window, Slide moves a full window along by one
+// value. Used by the Bollinger Band and volatility kernels; holds no heap
+// state, so it can live on the stack inside tight loops.
+//
+// Removing values cancels: when the window's variance collapses (say after
+// a gap or spike leaves it) the rounding error left over from the larger
+// variance dominates. NeedsRebuild reports when that has happened, and the
+// caller then recomputes the window exactly with Rebuild.
+class RollingStats {
+public:
+    void Add(double value) {
+        ++count;
+        double delta = value - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (value - mean);
+        peakM2 = std::max(peakM2, m2);
+    }
+
+    void Remove(double value) {
+        if (count <= 1) {
+            Clear();
+            return;
+        }
+        --count;
+        double delta = value - mean;
+        mean -= delta / static_cast<double>(count);
+        m2 = std::max(0.0, m2 - delta * (value - mean));
+    }
+
+    // Adds `incoming` and drops `outgoing` in one step, keeping the size
+    void Slide(double incoming, double outgoing) {
+        double delta = incoming - outgoing;
+        double oldMean = mean;
+        mean += delta / static_cast<double>(count);
+        m2 = std::max(0.0, m2 + delta * (incoming - mean + outgoing - oldMean));
+        peakM2 = std::max(peakM2, m2);
+    }
+
+    // True once the variance has fallen far enough below its peak since the
+    // last rebuild that cancellation error could show in ~12 digits
+    bool NeedsRebuild() const { return m2 * RebuildRatio < peakM2; }
+
+    // Recomputes the statistics of the window `values` exactly (two passes)
+    void Rebuild(const double* values, size_t n) {
+        RebuildFrom(n, [values](size_t i) { return values[i]; });
+    }
+
+    // Same, for a window whose i-th value is valueAt(i) (e.g. returns
+    // derived from closes on the fly); each value is requested twice
+    template <typename ValueAt>
+    void RebuildFrom(size_t n, ValueAt valueAt) {
+        count = n;
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += valueAt(i);
+        }
+        mean = n == 0 ? 0.0 : sum / static_cast<double>(n);
+        m2 = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            double d = valueAt(i) - mean;
+            m2 += d * d;
+        }
+        peakM2 = m2;
+    }
+
+    void Clear() {
+        count = 0;
+        mean = 0.0;
+        m2 = 0.0;
+        peakM2 = 0.0;
+    }
+
+    size_t Count() const { return count; }
+    double Mean() const { return mean; }
+    // Population variance (divides by the count, like CalculateVariance)
+    double Variance() const { return count == 0 ? 0.0 : m2 / static_cast<double>(count); }
+    double StdDev() const { return std::sqrt(Variance()); }
+
+private:
+    static constexpr double RebuildRatio = 1e4;
+
+    size_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;      // sum of squared deviations from the mean
+    double peakM2 = 0.0;  // largest m2 since the last Clear or Rebuild
+};
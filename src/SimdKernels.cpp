@@ -0,0 +1,503 @@
+#include "SimdKernels.h"
+#include <atomic>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SIMDKERNELS_X86 1
+#endif
+
+// Built with -ffp-contract=off (see CMakeLists.txt): the compiler must not
+// fuse multiply-adds on its own, or the scalar code would stop matching the
+// vector code.
+
+namespace SimdKernels {
+
+namespace {
+
+// Every implementation keeps this many interleaved partial sums: element i
+// of each full block goes to lane i % Lanes
+const size_t Lanes = 16;
+
+// Folds the lanes pairwise (8 apart, then 4, 2, 1) into lanes[0]
+double Fold(double* lanes) {
+    for (size_t width = Lanes / 2; width >= 1; width /= 2) {
+        for (size_t k = 0; k < width; ++k) {
+            lanes[k] += lanes[k + width];
+        }
+    }
+    return lanes[0];
+}
+
+std::atomic<bool> deterministic{false};
+
+void ReturnsScalar(const double* values, size_t count, double* out) {
+    for (size_t i = 0; i + 1 < count; ++i) {
+        out[i] = (values[i + 1] - values[i]) / values[i];
+    }
+}
+
+double SumScalar(const double* values, size_t count) {
+    double lanes[Lanes] = {};
+    size_t i = 0;
+    for (; i + Lanes <= count; i += Lanes) {
+        for (size_t k = 0; k < Lanes; ++k) {
+            lanes[k] += values[i + k];
+        }
+    }
+    double total = Fold(lanes);
+    for (; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+double CrossScalar(const double* x, const double* y, size_t count, double meanX, double meanY) {
+    double lanes[Lanes] = {};
+    size_t i = 0;
+    for (; i + Lanes <= count; i += Lanes) {
+        for (size_t k = 0; k < Lanes; ++k) {
+            lanes[k] += (x[i + k] - meanX) * (y[i + k] - meanY);
+        }
+    }
+    double total = Fold(lanes);
+    for (; i < count; ++i) {
+        total += (x[i] - meanX) * (y[i] - meanY);
+    }
+    return total;
+}
+
+void ProductsScalar(const double* x, const double* y, size_t count, double meanX, double meanY,
+                    double& sumXY, double& sumXX, double& sumYY) {
+    double xy[Lanes] = {}, xx[Lanes] = {}, yy[Lanes] = {};
+    size_t i = 0;
+    for (; i + Lanes <= count; i += Lanes) {
+        for (size_t k = 0; k < Lanes; ++k) {
+            double dx = x[i + k] - meanX;
+            double dy = y[i + k] - meanY;
+            xy[k] += dx * dy;
+            xx[k] += dx * dx;
+            yy[k] += dy * dy;
+        }
+    }
+    sumXY = Fold(xy);
+    sumXX = Fold(xx);
+    sumYY = Fold(yy);
+    for (; i < count; ++i) {
+        double dx = x[i] - meanX;
+        double dy = y[i] - meanY;
+        sumXY += dx * dy;
+        sumXX += dx * dx;
+        sumYY += dy * dy;
+    }
+}
+
+#ifdef SIMDKERNELS_X86
+
+// SSE2: 2 lanes per register, 8 registers per sum
+
+__attribute__((target("sse2")))
+void ReturnsSSE2(const double* values, size_t count, double* out) {
+    size_t i = 0;
+    for (; i + 2 < count; i += 2) {
+        __m128d current = _mm_loadu_pd(values + i);
+        __m128d next = _mm_loadu_pd(values + i + 1);
+        _mm_storeu_pd(out + i, _mm_div_pd(_mm_sub_pd(next, current), current));
+    }
+    ReturnsScalar(values + i, count - i, out + i);
+}
+
+__attribute__((target("sse2")))
+double SumSSE2(const double* values, size_t count) {
+    __m128d acc[8];
+    for (auto& a : acc) a = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + Lanes <= count; i += Lanes) {
+        for (size_t r = 0; r < 8; ++r) {
+            acc[r] = _mm_add_pd(acc[r], _mm_loadu_pd(values + i + 2 * r));
+        }
+    }
+    double lanes[Lanes];
+    for (size_t r = 0; r < 8; ++r) _mm_storeu_pd(lanes + 2 * r, acc[r]);
+    double total = Fold(lanes);
+    for (; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+__attribute__((target("sse2")))
+double CrossSSE2(const double* x, const double* y, size_t count, double meanX, double meanY) {
+    const __m128d mx = _mm_set1_pd(meanX);
+    const __m128d my = _mm_set1_pd(meanY);
+    __m128d acc[8];
+    for (auto& a : acc) a = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + Lanes <= count; i += Lanes) {
+        for (size_t r = 0; r < 8; ++r) {
+            __m128d dx = _mm_sub_pd(_mm_loadu_pd(x + i + 2 * r), mx);
+            __m128d dy = _mm_sub_pd(_mm_loadu_pd(y + i + 2 * r), my);
+            acc[r] = _mm_add_pd(acc[r], _mm_mul_pd(dx, dy));
+        }
+    }
+    double lanes[Lanes];
+    for (size_t r = 0; r < 8; ++r) _mm_storeu_pd(lanes + 2 * r, acc[r]);
+    double total = Fold(lanes);
+    for (; i < count; ++i) {
+        total += (x[i] - meanX) * (y[i] - meanY);
+    }
+    return total;
+}
+
+__attribute__((target("sse2")))
+void ProductsSSE2(const double* x, const double* y, size_t count, double meanX, double meanY,
+                  double& sumXY, double& sumXX, double& sumYY) {
+    const __m128d mx = _mm_set1_pd(meanX);
+    const __m128d my = _mm_set1_pd(meanY);
+    __m128d xy[8], xx[8], yy[8];
+    for (size_t r = 0; r < 8; ++r) xy[r] = xx[r] = yy[r] = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + Lanes <= count; i += Lanes) {
+        for (size_t r = 0; r < 8; ++r) {
+            __m128d dx = _mm_sub_pd(_mm_loadu_pd(x + i + 2 * r), mx);
+            __m128d dy = _mm_sub_pd(_mm_loadu_pd(y + i + 2 * r), my);
+            xy[r] = _mm_add_pd(xy[r], _mm_mul_pd(dx, dy));
+            xx[r] = _mm_add_pd(xx[r], _mm_mul_pd(dx, dx));
+            yy[r] = _mm_add_pd(yy[r], _mm_mul_pd(dy, dy));
+        }
+    }
+    double lanesXY[Lanes], lanesXX[Lanes], lanesYY[Lanes];
+    for (size_t r = 0; r < 8; ++r) {
+        _mm_storeu_pd(lanesXY + 2 * r, xy[r]);
+        _mm_storeu_pd(lanesXX + 2 * r, xx[r]);
+        _mm_storeu_pd(lanesYY + 2 * r, yy[r]);
+    }
+    sumXY = Fold(lanesXY);
+    sumXX = Fold(lanesXX);
+    sumYY = Fold(lanesYY);
+    for (; i < count; ++i) {
+        double dx = x[i] - meanX;
+        double dy = y[i] - meanY;
+        sumXY += dx * dy;
+        sumXX += dx * dx;
+        sumYY += dy * dy;
+    }
+}
+
+// AVX2: 4 lanes per register, 4 registers per sum. `Fused` selects FMA for
+// the multiply-adds.
+
+__attribute__((target("avx2,fma")))
+void ReturnsAVX2(const double* values, size_t count, double* out) {
+    size_t i = 0;
+    for (; i + 4 < count; i += 4) {
+        __m256d current = _mm256_loadu_pd(values + i);
+        __m256d next = _mm256_loadu_pd(values + i + 1);
+        _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_sub_pd(next, current), current));
+    }
+    ReturnsScalar(values + i, count - i, out + i);
+}
+
+__attribute__((target("avx2,fma")))
+double SumAVX2(const double* values, size_t count) {
+    __m256d acc[4];
+    for (auto& a : acc) a = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + Lanes <= count; i += Lanes) {
+        for (size_t r = 0; r < 4; ++r) {
+            acc[r] = _mm256_add_pd(acc[r], _mm256_loadu_pd(values + i + 4 * r));
+        }
+    }
+    double lanes[Lanes];
+    for (size_t r = 0; r < 4; ++r) _mm256_storeu_pd(lanes + 4 * r, acc[r]);
+    double total = Fold(lanes);
+    for (; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+template <bool Fused>
+__attribute__((target("avx2,fma")))
+inline __m256d MultiplyAddAVX2(__m256d a, __m256d b, __m256d acc) {
+    return Fused ? _mm256_fmadd_pd(a, b, acc) : _mm256_add_pd(acc, _mm256_mul_pd(a, b));
+}
+
+template <bool Fused>
+__attribute__((target("avx2,fma")))
+double CrossAVX2(const double* x, const double* y, size_t count, double meanX, double meanY) {
+    const __m256d mx = _mm256_set1_pd(meanX);
+    const __m256d my = _mm256_set1_pd(meanY);
+    __m256d acc[4];
+    for (auto& a : acc) a = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + Lanes <= count; i += Lanes) {
+        for (size_t r = 0; r < 4; ++r) {
+            __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + i + 4 * r), mx);
+            __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + i + 4 * r), my);
+            acc[r] = MultiplyAddAVX2<Fused>(dx, dy, acc[r]);
+        }
+    }
+    double lanes[Lanes];
+    for (size_t r = 0; r < 4; ++r) _mm256_storeu_pd(lanes + 4 * r, acc[r]);
+    double total = Fold(lanes);
+    for (; i < count; ++i) {
+        total += (x[i] - meanX) * (y[i] - meanY);
+    }
+    return total;
+}
+
+template <bool Fused>
+__attribute__((target("avx2,fma")))
+void ProductsAVX2(const double* x, const double* y, size_t count, double meanX, double meanY,
+                  double& sumXY, double& sumXX, double& sumYY) {
+    const __m256d mx = _mm256_set1_pd(meanX);
+    const __m256d my = _mm256_set1_pd(meanY);
+    __m256d xy[4], xx[4], yy[4];
+    for (size_t r = 0; r < 4; ++r) xy[r] = xx[r] = yy[r] = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + Lanes <= count; i += Lanes) {
+        for (size_t r = 0; r < 4; ++r) {
+            __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + i + 4 * r), mx);
+            __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + i + 4 * r), my);
+            xy[r] = MultiplyAddAVX2<Fused>(dx, dy, xy[r]);
+            xx[r] = MultiplyAddAVX2<Fused>(dx, dx, xx[r]);
+            yy[r] = MultiplyAddAVX2<Fused>(dy, dy, yy[r]);
+        }
+    }
+    double lanesXY[Lanes], lanesXX[Lanes], lanesYY[Lanes];
+    for (size_t r = 0; r < 4; ++r) {
+        _mm256_storeu_pd(lanesXY + 4 * r, xy[r]);
+        _mm256_storeu_pd(lanesXX + 4 * r, xx[r]);
+        _mm256_storeu_pd(lanesYY + 4 * r, yy[r]);
+    }
+    sumXY = Fold(lanesXY);
+    sumXX = Fold(lanesXX);
+    sumYY = Fold(lanesYY);
+    for (; i < count; ++i) {
+        double dx = x[i] - meanX;
+        double dy = y[i] - meanY;
+        sumXY += dx * dy;
+        sumXX += dx * dx;
+        sumYY += dy * dy;
+    }
+}
+
+// AVX-512: 8 lanes per register, 2 registers per sum
+
+__attribute__((target("avx512f")))
+void ReturnsAVX512(const double* values, size_t count, double* out) {
+    size_t i = 0;
+    for (; i + 8 < count; i += 8) {
+        __m512d current = _mm512_loadu_pd(values + i);
+        __m512d next = _mm512_loadu_pd(values + i + 1);
+        _mm512_storeu_pd(out + i, _mm512_div_pd(_mm512_sub_pd(next, current), current));
+    }
+    ReturnsScalar(values + i, count - i, out + i);
+}
+
+__attribute__((target("avx512f")))
+double SumAVX512(const double* values, size_t count) {
+    __m512d acc[2] = {_mm512_setzero_pd(), _mm512_setzero_pd()};
+    size_t i = 0;
+    for (; i + Lanes <= count; i += Lanes) {
+        acc[0] = _mm512_add_pd(acc[0], _mm512_loadu_pd(values + i));
+        acc[1] = _mm512_add_pd(acc[1], _mm512_loadu_pd(values + i + 8));
+    }
+    double lanes[Lanes];
+    _mm512_storeu_pd(lanes, acc[0]);
+    _mm512_storeu_pd(lanes + 8, acc[1]);
+    double total = Fold(lanes);
+    for (; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+template <bool Fused>
+__attribute__((target("avx512f")))
+inline __m512d MultiplyAddAVX512(__m512d a, __m512d b, __m512d acc) {
+    return Fused ? _mm512_fmadd_pd(a, b, acc) : _mm512_add_pd(acc, _mm512_mul_pd(a, b));
+}
+
+template <bool Fused>
+__attribute__((target("avx512f")))
+double CrossAVX512(const double* x, const double* y, size_t count, double meanX, double meanY) {
+    const __m512d mx = _mm512_set1_pd(meanX);
+    const __m512d my = _mm512_set1_pd(meanY);
+    __m512d acc[2] = {_mm512_setzero_pd(), _mm512_setzero_pd()};
+    size_t i = 0;
+    for (; i + Lanes <= count; i += Lanes) {
+        for (size_t r = 0; r < 2; ++r) {
+            __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(x + i + 8 * r), mx);
+            __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(y + i + 8 * r), my);
+            acc[r] = MultiplyAddAVX512<Fused>(dx, dy, acc[r]);
+        }
+    }
+    double lanes[Lanes];
+    _mm512_storeu_pd(lanes, acc[0]);
+    _mm512_storeu_pd(lanes + 8, acc[1]);
+    double total = Fold(lanes);
+    for (; i < count; ++i) {
+        total += (x[i] - meanX) * (y[i] - meanY);
+    }
+    return total;
+}
+
+template <bool Fused>
+__attribute__((target("avx512f")))
+void ProductsAVX512(const double* x, const double* y, size_t count, double meanX, double meanY,
+                    double& sumXY, double& sumXX, double& sumYY) {
+    const __m512d mx = _mm512_set1_pd(meanX);
+    const __m512d my = _mm512_set1_pd(meanY);
+    __m512d xy[2], xx[2], yy[2];
+    for (size_t r = 0; r < 2; ++r) xy[r] = xx[r] = yy[r] = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + Lanes <= count; i += Lanes) {
+        for (size_t r = 0; r < 2; ++r) {
+            __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(x + i + 8 * r), mx);
+            __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(y + i + 8 * r), my);
+            xy[r] = MultiplyAddAVX512<Fused>(dx, dy, xy[r]);
+            xx[r] = MultiplyAddAVX512<Fused>(dx, dx, xx[r]);
+            yy[r] = MultiplyAddAVX512<Fused>(dy, dy, yy[r]);
+        }
+    }
+    double lanesXY[Lanes], lanesXX[Lanes], lanesYY[Lanes];
+    for (size_t r = 0; r < 2; ++r) {
+        _mm512_storeu_pd(lanesXY + 8 * r, xy[r]);
+        _mm512_storeu_pd(lanesXX + 8 * r, xx[r]);
+        _mm512_storeu_pd(lanesYY + 8 * r, yy[r]);
+    }
+    sumXY = Fold(lanesXY);
+    sumXX = Fold(lanesXX);
+    sumYY = Fold(lanesYY);
+    for (; i < count; ++i) {
+        double dx = x[i] - meanX;
+        double dy = y[i] - meanY;
+        sumXY += dx * dy;
+        sumXX += dx * dx;
+        sumYY += dy * dy;
+    }
+}
+
+#endif // SIMDKERNELS_X86
+
+using ReturnsFn = void (*)(const double*, size_t, double*);
+using SumFn = double (*)(const double*, size_t);
+using CrossFn = double (*)(const double*, const double*, size_t, double, double);
+using ProductsFn = void (*)(const double*, const double*, size_t, double, double,
+                            double&, double&, double&);
+
+struct Implementation {
+    const char* name;
+    ReturnsFn returns;
+    SumFn sum;
+    CrossFn cross;
+    ProductsFn products;
+    CrossFn fusedCross;        // same as cross where there is no FMA
+    ProductsFn fusedProducts;
+};
+
+const Implementation Scalar = {
+    "scalar", ReturnsScalar, SumScalar, CrossScalar, ProductsScalar, CrossScalar, ProductsScalar
+};
+
+#ifdef SIMDKERNELS_X86
+const Implementation SSE2 = {
+    "sse2", ReturnsSSE2, SumSSE2, CrossSSE2, ProductsSSE2, CrossSSE2, ProductsSSE2
+};
+const Implementation AVX2 = {
+    "avx2", ReturnsAVX2, SumAVX2, CrossAVX2<false>, ProductsAVX2<false>,
+    CrossAVX2<true>, ProductsAVX2<true>
+};
+const Implementation AVX512 = {
+    "avx512", ReturnsAVX512, SumAVX512, CrossAVX512<false>, ProductsAVX512<false>,
+    CrossAVX512<true>, ProductsAVX512<true>
+};
+#endif
+
+bool Supported(const Implementation& implementation) {
+#ifdef SIMDKERNELS_X86
+    __builtin_cpu_init();
+    if (&implementation == &AVX512) return __builtin_cpu_supports("avx512f");
+    if (&implementation == &AVX2) return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    if (&implementation == &SSE2) return __builtin_cpu_supports("sse2");
+#endif
+    return &implementation == &Scalar;
+}
+
+const Implementation* SelectImplementation() {
+#ifdef SIMDKERNELS_X86
+    const Implementation* candidates[] = {&AVX512, &AVX2, &SSE2};
+    for (const Implementation* candidate : candidates) {
+        if (Supported(*candidate)) {
+            return candidate;
+        }
+    }
+#endif
+    return &Scalar;
+}
+
+std::atomic<const Implementation*>& Active() {
+    static std::atomic<const Implementation*> implementation{SelectImplementation()};
+    return implementation;
+}
+
+} // namespace
+
+void Returns(const double* values, size_t count, double* out) {
+    Active().load(std::memory_order_relaxed)->returns(values, count, out);
+}
+
+double Sum(const double* values, size_t count) {
+    return Active().load(std::memory_order_relaxed)->sum(values, count);
+}
+
+double SumCrossDeviations(const double* x, const double* y, size_t count,
+                          double meanX, double meanY) {
+    const Implementation* implementation = Active().load(std::memory_order_relaxed);
+    CrossFn cross = Deterministic() ? implementation->cross : implementation->fusedCross;
+    return cross(x, y, count, meanX, meanY);
+}
+
+double SumSquaredDeviations(const double* values, size_t count, double mean) {
+    return SumCrossDeviations(values, values, count, mean, mean);
+}
+
+void SumDeviationProducts(const double* x, const double* y, size_t count,
+                          double meanX, double meanY,
+                          double& sumXY, double& sumXX, double& sumYY) {
+    const Implementation* implementation = Active().load(std::memory_order_relaxed);
+    ProductsFn products = Deterministic() ? implementation->products : implementation->fusedProducts;
+    products(x, y, count, meanX, meanY, sumXY, sumXX, sumYY);
+}
+
+void SetDeterministic(bool value) {
+    deterministic.store(value, std::memory_order_relaxed);
+}
+
+bool Deterministic() {
+    return deterministic.load(std::memory_order_relaxed);
+}
+
+const char* ActiveImplementation() {
+    return Active().load(std::memory_order_relaxed)->name;
+}
+
+bool UseImplementation(const char* name) {
+    const Implementation* candidates[] = {
+#ifdef SIMDKERNELS_X86
+        &AVX512, &AVX2, &SSE2,
+#endif
+        &Scalar
+    };
+    for (const Implementation* candidate : candidates) {
+        if (std::strcmp(candidate->name, name) == 0 && Supported(*candidate)) {
+            Active().store(candidate, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace SimdKernels
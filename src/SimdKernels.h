@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+
+// Vectorized numeric kernels behind DataProcessor's returns, mean, variance,
+// correlation and covariance.
+//
+// The implementation is chosen once at runtime from what the CPU supports:
+// AVX-512, AVX2 (with FMA), SSE2 or plain scalar code. Every variant sums in
+// the same order - sixteen interleaved partial sums, folded pairwise, then
+// the leftover elements one by one - so switching ISA never changes a
+// result. The only ISA-dependent difference is that AVX2 and AVX-512 fuse
+// the multiply-adds in the squared/cross-product sums (one rounding instead
+// of two); SetDeterministic(true) turns that off, and results are then
+// bit-identical on every machine.
+namespace SimdKernels {
+
+// out[i] = (values[i + 1] - values[i]) / values[i] for i < count - 1
+void Returns(const double* values, size_t count, double* out);
+
+// Sum of values
+double Sum(const double* values, size_t count);
+
+// Sum of (values[i] - mean)^2
+double SumSquaredDeviations(const double* values, size_t count, double mean);
+
+// Sum of (x[i] - meanX) * (y[i] - meanY)
+double SumCrossDeviations(const double* x, const double* y, size_t count,
+                          double meanX, double meanY);
+
+// The cross sum together with both squared sums, in one pass (correlation)
+void SumDeviationProducts(const double* x, const double* y, size_t count,
+                          double meanX, double meanY,
+                          double& sumXY, double& sumXX, double& sumYY);
+
+// When true, multiply-adds are never fused, so results do not depend on
+// the CPU. Off by default.
+void SetDeterministic(bool deterministic);
+bool Deterministic();
+
+// Name of the active implementation ("avx512", "avx2", "sse2" or "scalar")
+const char* ActiveImplementation();
+
+// Switches to the named implementation if this CPU supports it (for
+// benchmarks and cross-checking); returns false and changes nothing
+// otherwise. Calls already running finish on the old implementation.
+bool UseImplementation(const char* name);
+
+} // namespace SimdKernels
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// Non-owning view of a contiguous run of T: a window of a series, a slice
+// of a column, a preallocated output buffer or mmapped memory. This is
+// std::span when the standard library has it, and a minimal stand-in with
+// the same interface (the parts this code uses) under C++17.
+
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#define STOCKSENSE_STD_SPAN 1
+#endif
+#endif
+
+#ifdef STOCKSENSE_STD_SPAN
+
+template <typename T>
+using Span = std::span<T>;
+
+#else
+
+template <typename T>
+class Span {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    constexpr Span() = default;
+    constexpr Span(T* first, size_t n) : ptr(first), count(n) {}
+
+    template <size_t N>
+    constexpr Span(T (&array)[N]) : ptr(array), count(N) {}
+
+    // Vectors convert implicitly, const ones only to Span<const U>
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    Span(std::vector<U>& values) : ptr(values.data()), count(values.size()) {}
+    template <typename U, typename = std::enable_if_t<std::is_convertible<const U (*)[], T (*)[]>::value>>
+    Span(const std::vector<U>& values) : ptr(values.data()), count(values.size()) {}
+
+    // Span<double> -> Span<const double>
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr Span(const Span<U>& other) : ptr(other.data()), count(other.size()) {}
+
+    constexpr T* data() const { return ptr; }
+    constexpr size_t size() const { return count; }
+    constexpr bool empty() const { return count == 0; }
+    constexpr T& operator[](size_t i) const { return ptr[i]; }
+    constexpr T* begin() const { return ptr; }
+    constexpr T* end() const { return ptr + count; }
+
+    constexpr Span first(size_t n) const { return Span(ptr, n); }
+    constexpr Span last(size_t n) const { return Span(ptr + count - n, n); }
+    constexpr Span subspan(size_t offset, size_t n = npos) const {
+        return Span(ptr + offset, n == npos ? count - offset : n);
+    }
+
+private:
+    T* ptr = nullptr;
+    size_t count = 0;
+};
+
+#endif
@@ -1,306 +1,479 @@
 #include "StockDataLoader.h"
-#include "rapidcsv.h"
-#include <curl/curl.h>
-#include <sstream>
+#include "ChartDecoder.h"
+#include "ColumnStore.h"
+#include "DateUtil.h"
+#include "HistoryCache.h"
+#include "CsvBarParser.h"
+#include "ThreadPool.h"
 #include <iostream>
 #include <ctime>
 #include <algorithm>
 #include <iomanip>
+#include <fstream>
+#include <cstdio>
+#include <functional>
+#include <cmath>
 
-static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* output) {
-    size_t totalSize = size * nmemb;
-    output->append((char*)contents, totalSize);
-    return totalSize;
+// Read size used when streaming CSV files from disk
+static const size_t CsvReadChunkSize = 64 * 1024;
+
+// Thread-safe local time; std::localtime's buffer is shared between threads
+static void LocalTime(std::time_t t, std::tm& timeinfo) {
+#ifdef _WIN32
+    localtime_s(&timeinfo, &t);
+#else
+    localtime_r(&t, &timeinfo);
+#endif
+}
+
+// Runs `loadOne` for every source on a bounded pool, keeping input order
+static std::vector<BatchLoadResult> RunBatch(
+    const std::vector<std::string>& sources, size_t maxWorkers,
+    const std::function<PriceSeries(const std::string&)>& loadOne) {
+    std::vector<BatchLoadResult> results(sources.size());
+    if (sources.empty()) {
+        return results;
+    }
+
+    size_t workers = maxWorkers == 0 ? ThreadPool::DefaultWorkerCount() : maxWorkers;
+    ThreadPool pool(std::min(workers, sources.size()));
+    pool.ParallelFor(sources.size(), [&](size_t i) {
+        BatchLoadResult& result = results[i];
+        result.source = sources[i];
+        try {
+            result.data = loadOne(sources[i]);
+            if (result.data.empty()) {
+                result.error = "No data loaded for " + sources[i];
+            }
+        } catch (const std::exception& e) {
+            result.error = e.what();
+        }
+    });
+    return results;
+}
+
+// Builds a LiveQuote from session figures in `meta`, falling back to the
+// last bar of `bars` (if any) for fields the payload left out
+static LiveQuote MakeQuote(const std::string& ticker, const ChartMeta& meta, const PriceSeries& bars) {
+    LiveQuote quote{};
+    quote.ticker = ticker;
+    
+    auto pick = [](double preferred, double fallback) {
+        return !std::isnan(preferred) ? preferred : (!std::isnan(fallback) ? fallback : 0.0);
+    };
+    bool hasBar = !bars.empty();
+    
+    quote.currentPrice = pick(meta.regularMarketPrice, hasBar ? bars.close.back() : NAN);
+    quote.previousClose = pick(meta.previousClose, meta.chartPreviousClose);
+    quote.open = pick(meta.regularMarketOpen, hasBar ? bars.open.back() : NAN);
+    quote.high = pick(meta.regularMarketDayHigh, hasBar ? bars.high.back() : NAN);
+    quote.low = pick(meta.regularMarketDayLow, hasBar ? bars.low.back() : NAN);
+    quote.volume = static_cast<long>(pick(meta.regularMarketVolume, hasBar ? bars.volume.back() : NAN));
+    
+    // Calculate change
+    quote.change = quote.currentPrice - quote.previousClose;
+    if (quote.previousClose > 0) {
+        quote.changePercent = (quote.change / quote.previousClose) * 100.0;
+    }
+    
+    // Time of the last trade, or now if the payload does not say
+    std::time_t updated = meta.regularMarketTime > 0 ? static_cast<std::time_t>(meta.regularMarketTime)
+                                                     : std::time(nullptr);
+    std::tm timeinfo{};
+    LocalTime(updated, timeinfo);
+    char buffer[80];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &timeinfo);
+    quote.lastUpdate = std::string(buffer);
+    
+    return quote;
+}
+
+StockDataLoader::StockDataLoader()
+    : http(std::make_shared<HttpClient>()) {
+}
+
+StockDataLoader::StockDataLoader(std::shared_ptr<HttpClient> httpClient)
+    : http(std::move(httpClient)) {
 }
 
 std::vector<StockData> StockDataLoader::LoadFromCSV(const std::string& filepath) {
-    std::vector<StockData> data;
+    return LoadSeriesFromCSV(filepath).ToRows();
+}
+
+PriceSeries StockDataLoader::LoadSeriesFromCSV(const std::string& filepath) {
+    PriceSeries data;
     
     if (filepath.empty()) {
         std::cerr << "Error: Empty filepath provided\n";
         return data;
     }
     
-    try {
-        rapidcsv::Document doc(filepath, rapidcsv::LabelParams(0, -1));
-
-        auto dates = doc.GetColumn<std::string>("Date");
-        auto opens = doc.GetColumn<double>("Open");
-        auto highs = doc.GetColumn<double>("High");
-        auto lows = doc.GetColumn<double>("Low");
-        auto closes = doc.GetColumn<double>("Close");
-        auto volumes = doc.GetColumn<double>("Volume");
-
-        // Validate data consistency
-        size_t expectedSize = dates.size();
-        if (opens.size() != expectedSize || highs.size() != expectedSize ||
-            lows.size() != expectedSize || closes.size() != expectedSize ||
-            volumes.size() != expectedSize) {
-            std::cerr << "Warning: Inconsistent column sizes in CSV\n";
+    std::FILE* file = std::fopen(filepath.c_str(), "rb");
+    if (!file) {
+        std::cerr << "Error loading CSV from " << filepath << ": could not open file\n";
+        return data;
+    }
+
+    // Stream the file through a fixed buffer; rows go straight into `data`
+    CsvBarParser parser(data, true);
+    std::vector<char> buffer(CsvReadChunkSize);
+    size_t bytesRead;
+    while ((bytesRead = std::fread(buffer.data(), 1, buffer.size(), file)) > 0) {
+        parser.Feed(buffer.data(), bytesRead);
+    }
+    bool readError = std::ferror(file) != 0;
+    std::fclose(file);
+    parser.Finish();
+
+    if (readError) {
+        std::cerr << "Error loading CSV from " << filepath << ": read failed\n";
+        data.clear();
+        return data;
+    }
+
+    if (parser.RowsAccepted() == 0) {
+        std::cerr << "Error: No valid rows found in CSV file\n";
+    } else if (parser.RowsAccepted() < parser.RowsRead()) {
+        std::cerr << "Warning: Only " << parser.RowsAccepted() << " of " << parser.RowsRead() 
+                 << " rows were valid\n";
+    }
+    
+    return data;
+}
+
+PriceSeries StockDataLoader::LoadSeriesFromBinary(const std::string& filepath) {
+    if (filepath.empty()) {
+        std::cerr << "Error: Empty filepath provided\n";
+        return PriceSeries();
+    }
+    return ColumnStore::Map(filepath);
+}
+
+bool StockDataLoader::ConvertCSVToBinary(const std::string& csvPath, const std::string& binaryPath) {
+    PriceSeries data = LoadSeriesFromCSV(csvPath);
+    if (data.empty()) {
+        std::cerr << "Error: Nothing to convert in " << csvPath << "\n";
+        return false;
+    }
+    return ColumnStore::Write(binaryPath, data);
+}
+
+PriceSeries StockDataLoader::LoadLocalSeries(const std::string& ticker) {
+    std::string binaryPath = ticker + ".scol";
+    if (std::ifstream(binaryPath).good()) {
+        PriceSeries data = LoadSeriesFromBinary(binaryPath);
+        if (!data.empty()) {
+            return data;
         }
+    }
+    return LoadSeriesFromCSV(ticker + ".csv");
+}
+
+std::vector<BatchLoadResult> StockDataLoader::LoadBatchFromCSV(
+    const std::vector<std::string>& filepaths, size_t maxWorkers) {
+    return RunBatch(filepaths, maxWorkers,
+                    [this](const std::string& path) { return LoadSeriesFromCSV(path); });
+}
 
-        size_t validRows = 0;
-        for (size_t i = 0; i < dates.size(); ++i) {
-            // Validate data
-            if (highs[i] < lows[i]) {
-                std::cerr << "Warning: Row " << i << " has High < Low, skipping\n";
-                continue;
+std::vector<BatchLoadResult> StockDataLoader::LoadBatchFromAPI(
+    const std::vector<std::string>& tickers, const std::string& startDate,
+    const std::string& endDate, size_t maxWorkers) {
+    if (historyCache) {
+        return historyCache->LoadBatch(tickers, startDate, endDate);
+    }
+    return RunBatch(tickers, maxWorkers, [&](const std::string& ticker) {
+        return LoadSeriesFromAPI(ticker, startDate, endDate);
+    });
+}
+
+std::vector<BatchLoadResult> StockDataLoader::LoadBatchLocal(
+    const std::vector<std::string>& tickers, size_t maxWorkers) {
+    return RunBatch(tickers, maxWorkers,
+                    [this](const std::string& ticker) { return LoadLocalSeries(ticker); });
+}
+
+void StockDataLoader::SetFetchLimits(size_t maxInFlight, size_t maxPerHost) {
+    std::lock_guard<std::mutex> lock(engineMutex);
+    fetchMaxInFlight = maxInFlight;
+    fetchMaxPerHost = maxPerHost;
+}
+
+void StockDataLoader::SetFixtures(std::shared_ptr<HttpFixtures> store) {
+    std::lock_guard<std::mutex> lock(engineMutex);
+    fixtures = store;
+    http->SetFixtures(store);
+    if (engine) {
+        engine->SetFixtures(store);
+    }
+}
+
+FetchEngine& StockDataLoader::Engine() {
+    std::lock_guard<std::mutex> lock(engineMutex);
+    if (!engine) {
+        engine = std::make_unique<FetchEngine>(fetchMaxInFlight, fetchMaxPerHost);
+        engine->SetFixtures(fixtures);
+    }
+    return *engine;
+}
+
+std::vector<BatchLoadResult> StockDataLoader::FetchHistories(
+    const std::vector<std::string>& tickers, const std::string& startDate,
+    const std::string& endDate) {
+    FetchEngine& fetcher = Engine();
+    std::vector<BatchLoadResult> results(tickers.size());
+    std::vector<std::unique_ptr<CsvBarParser>> parsers(tickers.size());
+    std::vector<std::future<FetchResult>> pending;
+    pending.reserve(tickers.size());
+
+    // CSV bodies are parsed on the event loop as they download; chart JSON
+    // is buffered and decoded once complete
+    for (size_t i = 0; i < tickers.size(); ++i) {
+        results[i].source = tickers[i];
+        if (historySource == ChartAPI) {
+            pending.push_back(fetcher.Submit(HistoryURL(tickers[i], startDate, endDate)));
+            continue;
+        }
+        parsers[i] = std::make_unique<CsvBarParser>(results[i].data);
+        CsvBarParser* parser = parsers[i].get();
+        pending.push_back(fetcher.Submit(HistoryURL(tickers[i], startDate, endDate),
+                                         [parser](const char* data, size_t length) {
+                                             parser->Feed(data, length);
+                                             return true;
+                                         }));
+    }
+
+    for (size_t i = 0; i < tickers.size(); ++i) {
+        FetchResult response = pending[i].get();
+        if (!response.error.empty()) {
+            std::cerr << "Error: Could not fetch history for " << tickers[i] << " ("
+                      << response.error << ")\n";
+            results[i].data.clear();
+            results[i].error = response.error;
+            continue;
+        }
+        // A well-formed response with no bars (a range before the
+        // listing date, or only weekends and holidays) is not an error
+        if (parsers[i]) {
+            parsers[i]->Finish();
+            if (!parsers[i]->HeaderSeen() || (parsers[i]->RowsRead() > 0 && parsers[i]->RowsAccepted() == 0)) {
+                results[i].error = "Could not parse history for " + tickers[i];
             }
-            if (opens[i] <= 0 || closes[i] <= 0 || volumes[i] < 0) {
-                std::cerr << "Warning: Row " << i << " has invalid values, skipping\n";
-                continue;
+        } else {
+            ChartDocument chart;
+            if (ChartDecoder::Decode(response.body, chart)) {
+                results[i].data = std::move(chart.bars);
+            } else {
+                results[i].error = "Could not parse history for " + tickers[i] + ": " + chart.error;
             }
-            
-            data.push_back({ dates[i], opens[i], highs[i], lows[i], closes[i], volumes[i] });
-            validRows++;
         }
-        
-        if (validRows == 0) {
-            std::cerr << "Error: No valid rows found in CSV file\n";
-        } else if (validRows < dates.size()) {
-            std::cerr << "Warning: Only " << validRows << " of " << dates.size() 
-                     << " rows were valid\n";
+        if (!results[i].error.empty()) {
+            std::cerr << "Error: " << results[i].error << "\n";
+            results[i].data.clear();
         }
-    } 
-    catch (const std::exception& e) {
-        std::cerr << "Error loading CSV from " << filepath << ": " << e.what() << std::endl;
     }
-    
-    return data;
+    return results;
 }
 
-std::string StockDataLoader::FetchFromURL(const std::string& url) {
-    CURL* curl = curl_easy_init();
-    std::string readBuffer;
+std::vector<BatchLoadResult> StockDataLoader::LoadHistories(
+    const std::vector<std::string>& tickers, const std::string& startDate,
+    const std::string& endDate) {
+    if (historyCache) {
+        return historyCache->LoadBatch(tickers, startDate, endDate);
+    }
+    return FetchHistories(tickers, startDate, endDate);
+}
 
-    if (!curl) {
-        std::cerr << "Error: Failed to initialize CURL\n";
-        return readBuffer;
+std::vector<LiveQuote> StockDataLoader::FetchQuotes(const std::vector<std::string>& tickers) {
+    std::vector<std::string> urls;
+    urls.reserve(tickers.size());
+    for (const auto& ticker : tickers) {
+        urls.push_back(QuoteURL(ticker));
     }
-    
-    if (url.empty()) {
-        std::cerr << "Error: Empty URL provided\n";
-        curl_easy_cleanup(curl);
-        return readBuffer;
+    std::vector<FetchResult> responses = Engine().FetchAll(urls);
+
+    std::vector<LiveQuote> quotes;
+    quotes.reserve(tickers.size());
+    for (size_t i = 0; i < tickers.size(); ++i) {
+        if (responses[i].error.empty()) {
+            quotes.push_back(ParseQuoteJSON(responses[i].body, tickers[i]));
+        } else {
+            std::cerr << "Error: Could not fetch quote for " << tickers[i] << " ("
+                      << responses[i].error << ")\n";
+            LiveQuote quote{};
+            quote.ticker = tickers[i];
+            quotes.push_back(quote);
+        }
     }
+    return quotes;
+}
 
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    
-    CURLcode res = curl_easy_perform(curl);
-    
-    if (res != CURLE_OK) {
-        std::cerr << "CURL Error: " << curl_easy_strerror(res) << "\n";
-        readBuffer.clear();
-    } else {
-        long responseCode;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &responseCode);
-        if (responseCode != 200) {
-            std::cerr << "HTTP Error: Received status code " << responseCode << "\n";
-            readBuffer.clear();
+std::vector<LiveQuote> StockDataLoader::FetchQuoteBatch(const std::vector<std::string>& symbols,
+                                                        size_t symbolsPerRequest) {
+    std::vector<LiveQuote> quotes;
+    if (symbols.empty()) {
+        return quotes;
+    }
+    if (symbolsPerRequest == 0) {
+        symbolsPerRequest = symbols.size();
+    }
+
+    // One v7 request per group of symbols, all groups in flight at once
+    FetchEngine& fetcher = Engine();
+    std::vector<std::future<FetchResult>> pending;
+    for (size_t first = 0; first < symbols.size(); first += symbolsPerRequest) {
+        size_t last = std::min(symbols.size(), first + symbolsPerRequest);
+        std::vector<std::string> group(symbols.begin() + first, symbols.begin() + last);
+        pending.push_back(fetcher.Submit(QuoteBatchURL(group)));
+    }
+
+    quotes.reserve(symbols.size());
+    std::vector<ChartMeta> entries;
+    std::string error;
+    for (auto& future : pending) {
+        FetchResult response = future.get();
+        if (!response.error.empty()) {
+            std::cerr << "Error: Quote batch request failed (" << response.error << ")\n";
+            continue;
+        }
+        if (!ChartDecoder::DecodeQuotes(response.body, entries, error)) {
+            std::cerr << "Error parsing quote JSON: " << error << "\n";
+            continue;
+        }
+        for (const ChartMeta& entry : entries) {
+            quotes.push_back(MakeQuote(entry.symbol, entry, PriceSeries()));
         }
     }
-    
-    curl_easy_cleanup(curl);
-    return readBuffer;
+    return quotes;
+}
+
+std::string StockDataLoader::FetchFromURL(const std::string& url) {
+    return http->Get(url);
 }
 
 std::vector<StockData> StockDataLoader::LoadFromAPI(
     const std::string& ticker, const std::string& startDate, const std::string& endDate) {
+    return LoadSeriesFromAPI(ticker, startDate, endDate).ToRows();
+}
 
-    // Convert dates from YYYY-MM-DD to UNIX timestamps
-    // Simple parser for YYYY-MM-DD format
-    auto dateToTimestamp = [](const std::string& dateStr) -> long {
-        // Format: YYYY-MM-DD
-        if (dateStr.length() != 10) return 0;
-        
-        int year = std::stoi(dateStr.substr(0, 4));
-        int month = std::stoi(dateStr.substr(5, 2));
-        int day = std::stoi(dateStr.substr(8, 2));
-        
-        // Simple date to timestamp conversion (approximate)
-        // For more accuracy, use a proper date library
-        std::tm timeinfo = {};
-        timeinfo.tm_year = year - 1900;
-        timeinfo.tm_mon = month - 1;
-        timeinfo.tm_mday = day;
-        timeinfo.tm_hour = 0;
-        timeinfo.tm_min = 0;
-        timeinfo.tm_sec = 0;
-        
-        return std::mktime(&timeinfo);
-    };
-    
-    long period1 = dateToTimestamp(startDate);
-    long period2 = dateToTimestamp(endDate);
-    
-    if (period1 == 0 || period2 == 0) {
+std::string StockDataLoader::HistoryURL(
+    const std::string& ticker, const std::string& startDate, const std::string& endDate) const {
+    // Convert dates from YYYY-MM-DD to UNIX timestamps (UTC midnight)
+    int32_t startDays, endDays;
+    if (!DateUtil::ParseDate(startDate, startDays) || !DateUtil::ParseDate(endDate, endDays)) {
         std::cerr << "Warning: Invalid date format. Using default dates.\n";
-        period1 = 1704067200; // 2024-01-01
-        period2 = 1735689600; // 2025-01-01
+        startDays = DateUtil::DaysFromCivil(2024, 1, 1);
+        endDays = DateUtil::DaysFromCivil(2025, 1, 1);
     }
+    long period1 = static_cast<long>(DateUtil::DaysToUnixSeconds(startDays));
+    long period2 = static_cast<long>(DateUtil::DaysToUnixSeconds(endDays));
     
-    std::string url = "https://query1.finance.yahoo.com/v7/finance/download/" + ticker +
-                      "?period1=" + std::to_string(period1) + 
-                      "&period2=" + std::to_string(period2) + 
-                      "&interval=1d&events=history";
-    std::string csvContent = FetchFromURL(url);
-    return ParseCSV(csvContent);
+    std::string endpoint = historySource == ChartAPI ? "/v8/finance/chart/" : "/v7/finance/download/";
+    return baseURL + endpoint + ticker +
+           "?period1=" + std::to_string(period1) + 
+           "&period2=" + std::to_string(period2) + 
+           "&interval=1d&events=history";
 }
 
-std::vector<StockData> StockDataLoader::ParseCSV(const std::string& csvContent) {
-    std::vector<StockData> data;
-    std::stringstream ss(csvContent);
-    std::string line;
-    bool firstLine = true;
-
-    while (std::getline(ss, line)) {
-        if (firstLine) { firstLine = false; continue; }  // skip header
+std::string StockDataLoader::QuoteURL(const std::string& ticker) const {
+    return baseURL + "/v8/finance/chart/" + ticker + "?interval=1d&range=1d";
+}
 
-        std::stringstream lineStream(line);
-        std::string cell;
-        std::vector<std::string> tokens;
+std::string StockDataLoader::QuoteBatchURL(const std::vector<std::string>& symbols) const {
+    std::string url = baseURL + "/v7/finance/quote?symbols=";
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        if (i > 0) {
+            url += ',';
+        }
+        url += symbols[i];
+    }
+    return url;
+}
 
-        while (std::getline(lineStream, cell, ',')) tokens.push_back(cell);
-        if (tokens.size() < 6) continue;
+PriceSeries StockDataLoader::ParseChartJSON(const std::string& jsonContent, const std::string& ticker) {
+    ChartDocument chart;
+    if (!ChartDecoder::Decode(jsonContent, chart)) {
+        std::cerr << "Error parsing chart for " << ticker << ": " << chart.error << "\n";
+        return PriceSeries();
+    }
+    return std::move(chart.bars);
+}
 
-        try {
-            data.push_back({
-                tokens[0],
-                std::stod(tokens[1]),
-                std::stod(tokens[2]),
-                std::stod(tokens[3]),
-                std::stod(tokens[4]),
-                std::stod(tokens[6])
-            });
-        } catch (...) {
-            continue; // skip bad rows
+PriceSeries StockDataLoader::LoadSeriesFromAPI(
+    const std::string& ticker, const std::string& startDate, const std::string& endDate) {
+    if (historyCache) {
+        return historyCache->Load(ticker, startDate, endDate);
+    }
+    if (historySource == ChartAPI) {
+        std::string jsonContent = FetchFromURL(HistoryURL(ticker, startDate, endDate));
+        if (jsonContent.empty()) {
+            return PriceSeries();
         }
+        return ParseChartJSON(jsonContent, ticker);
+    }
+
+    PriceSeries data;
+    CsvBarParser parser(data);  // header skipped, unparseable rows dropped
+
+    // Rows are parsed straight out of the write callback as they arrive,
+    // so the response body is never held in memory
+    bool ok = http->Get(HistoryURL(ticker, startDate, endDate),
+                        [&parser](const char* chunk, size_t length) {
+                            parser.Feed(chunk, length);
+                            return true;
+                        });
+    if (!ok) {
+        data.clear();  // drop any rows from a partial download
+        return data;
     }
+    parser.Finish();
     return data;
 }
 
 LiveQuote StockDataLoader::GetLatestQuote(const std::string& ticker) {
-    LiveQuote quote;
-    quote.ticker = ticker;
-    
-    // Use Yahoo Finance quote API
-    std::string url = "https://query1.finance.yahoo.com/v8/finance/chart/" + ticker + 
-                      "?interval=1d&range=1d";
-    
-    std::string jsonContent = FetchFromURL(url);
+    std::string jsonContent = FetchFromURL(QuoteURL(ticker));
     
     if (jsonContent.empty()) {
         std::cerr << "Error: Could not fetch quote for " << ticker << "\n";
+        LiveQuote quote{};
+        quote.ticker = ticker;
         return quote;
     }
     
-    // Parse JSON response (simplified - for production use a JSON library)
-    try {
-        // Extract current price from JSON
-        size_t pricePos = jsonContent.find("\"regularMarketPrice\":");
-        if (pricePos != std::string::npos) {
-            size_t start = jsonContent.find_first_of("0123456789.", pricePos);
-            size_t end = jsonContent.find_first_not_of("0123456789.", start);
-            if (start != std::string::npos && end != std::string::npos) {
-                quote.currentPrice = std::stod(jsonContent.substr(start, end - start));
-            }
-        }
-        
-        // Extract previous close
-        size_t prevClosePos = jsonContent.find("\"previousClose\":");
-        if (prevClosePos != std::string::npos) {
-            size_t start = jsonContent.find_first_of("0123456789.", prevClosePos);
-            size_t end = jsonContent.find_first_not_of("0123456789.", start);
-            if (start != std::string::npos && end != std::string::npos) {
-                quote.previousClose = std::stod(jsonContent.substr(start, end - start));
-            }
-        }
-        
-        // Extract open
-        size_t openPos = jsonContent.find("\"open\":");
-        if (openPos != std::string::npos) {
-            size_t start = jsonContent.find_first_of("0123456789.", openPos);
-            size_t end = jsonContent.find_first_not_of("0123456789.", start);
-            if (start != std::string::npos && end != std::string::npos) {
-                quote.open = std::stod(jsonContent.substr(start, end - start));
-            }
-        }
-        
-        // Extract high
-        size_t highPos = jsonContent.find("\"high\":");
-        if (highPos != std::string::npos) {
-            size_t start = jsonContent.find_first_of("0123456789.", highPos);
-            size_t end = jsonContent.find_first_not_of("0123456789.", start);
-            if (start != std::string::npos && end != std::string::npos) {
-                quote.high = std::stod(jsonContent.substr(start, end - start));
-            }
-        }
-        
-        // Extract low
-        size_t lowPos = jsonContent.find("\"low\":");
-        if (lowPos != std::string::npos) {
-            size_t start = jsonContent.find_first_of("0123456789.", lowPos);
-            size_t end = jsonContent.find_first_not_of("0123456789.", start);
-            if (start != std::string::npos && end != std::string::npos) {
-                quote.low = std::stod(jsonContent.substr(start, end - start));
-            }
-        }
-        
-        // Extract volume
-        size_t volumePos = jsonContent.find("\"volume\":");
-        if (volumePos != std::string::npos) {
-            size_t start = jsonContent.find_first_of("0123456789", volumePos);
-            size_t end = jsonContent.find_first_not_of("0123456789", start);
-            if (start != std::string::npos && end != std::string::npos) {
-                quote.volume = std::stol(jsonContent.substr(start, end - start));
-            }
-        }
-        
-        // Calculate change
-        quote.change = quote.currentPrice - quote.previousClose;
-        if (quote.previousClose > 0) {
-            quote.changePercent = (quote.change / quote.previousClose) * 100.0;
-        }
-        
-        // Get current time
-        std::time_t now = std::time(nullptr);
-        std::tm* timeinfo = std::localtime(&now);
-        char buffer[80];
-        std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", timeinfo);
-        quote.lastUpdate = std::string(buffer);
-        
-    } catch (const std::exception& e) {
-        std::cerr << "Error parsing quote JSON: " << e.what() << "\n";
-    }
-    
-    return quote;
+    return ParseQuoteJSON(jsonContent, ticker);
 }
 
 std::vector<StockData> StockDataLoader::GetRecentData(const std::string& ticker, int days) {
+    return GetRecentSeries(ticker, days).ToRows();
+}
+
+PriceSeries StockDataLoader::GetRecentSeries(const std::string& ticker, int days) {
     // Get current date
     std::time_t now = std::time(nullptr);
-    std::tm* timeinfo = std::localtime(&now);
+    std::tm timeinfo{};
+    LocalTime(now, timeinfo);
     
     // Calculate start date (N days ago)
-    std::tm startDate = *timeinfo;
+    std::tm startDate = timeinfo;
     startDate.tm_mday -= days;
     std::mktime(&startDate);
     
     // Format dates
     char endDateStr[11];
-    std::strftime(endDateStr, sizeof(endDateStr), "%Y-%m-%d", timeinfo);
+    std::strftime(endDateStr, sizeof(endDateStr), "%Y-%m-%d", &timeinfo);
     
     char startDateStr[11];
     std::strftime(startDateStr, sizeof(startDateStr), "%Y-%m-%d", &startDate);
     
-    return LoadFromAPI(ticker, std::string(startDateStr), std::string(endDateStr));
+    return LoadSeriesFromAPI(ticker, std::string(startDateStr), std::string(endDateStr));
 }
 
 LiveQuote StockDataLoader::ParseQuoteJSON(const std::string& jsonContent, const std::string& ticker) {
-    // This is a simplified parser - for production, use a JSON library like nlohmann/json
-    return GetLatestQuote(ticker); // Fallback to main function
+    ChartDocument chart;
+    if (!ChartDecoder::Decode(jsonContent, chart)) {
+        std::cerr << "Error parsing quote JSON: " << chart.error << "\n";
+        LiveQuote quote{};
+        quote.ticker = ticker;
+        return quote;
+    }
+    return MakeQuote(ticker, chart.meta, chart.bars);
 }
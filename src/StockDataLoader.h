@@ -1,7 +1,14 @@
 #pragma once
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "StockData.h"
+#include "PriceSeries.h"
+#include "HttpClient.h"
+#include "FetchEngine.h"
+
+class HistoryCache;
 
 struct LiveQuote {
     std::string ticker;
@@ -16,8 +23,46 @@ struct LiveQuote {
     std::string lastUpdate;
 };
 
+// Outcome of one entry in a batch load; batches return these in input order
+struct BatchLoadResult {
+    std::string source;  // ticker or file path as requested
+    PriceSeries data;
+    std::string error;   // empty on success
+};
+
 class StockDataLoader {
 public:
+    // Network requests go through `httpClient`, whose pooled connections
+    // can be shared between loaders; by default each loader owns one
+    StockDataLoader();
+    explicit StockDataLoader(std::shared_ptr<HttpClient> httpClient);
+
+    // Scheme and host that API URLs are built on (default: Yahoo Finance).
+    // Point this at a local stand-in server to test without the network.
+    void SetBaseURL(const std::string& url) { baseURL = url; }
+    const std::string& GetBaseURL() const { return baseURL; }
+
+    // Endpoint behind LoadSeriesFromAPI, GetRecentSeries and FetchHistories:
+    // the v7 CSV download (default) or the v8 chart JSON
+    enum HistorySource { CsvDownload, ChartAPI };
+    void SetHistorySource(HistorySource source) { historySource = source; }
+    HistorySource GetHistorySource() const { return historySource; }
+
+    // Limits for the asynchronous fetch engine behind FetchHistories and
+    // FetchQuotes; only takes effect before the first batch fetch
+    void SetFetchLimits(size_t maxInFlight, size_t maxPerHost);
+
+    // Records every response to, or replays them from, an HttpFixtures
+    // directory on both the single-request and batch paths; nullptr goes
+    // back to live requests. Set before fetching.
+    void SetFixtures(std::shared_ptr<HttpFixtures> store);
+
+    // Serves LoadSeriesFromAPI, GetRecentSeries, LoadBatchFromAPI and
+    // LoadHistories from an on-disk HistoryCache, so repeated loads only
+    // request the dates not stored yet; nullptr (the default) loads
+    // straight from the API. FetchHistories always goes to the network.
+    void SetHistoryCache(std::shared_ptr<HistoryCache> cache) { historyCache = std::move(cache); }
+
     // Load data from a local CSV file
     std::vector<StockData> LoadFromCSV(const std::string& filepath);
 
@@ -32,8 +77,76 @@ public:
     // Get recent data (last N days) - useful for daily updates
     std::vector<StockData> GetRecentData(const std::string& ticker, int days = 30);
 
+    // Columnar variants of the loaders above; the row-based functions
+    // are thin adapters over these
+    PriceSeries LoadSeriesFromCSV(const std::string& filepath);
+    PriceSeries LoadSeriesFromAPI(const std::string& ticker,
+                                  const std::string& startDate,
+                                  const std::string& endDate);
+    PriceSeries GetRecentSeries(const std::string& ticker, int days = 30);
+
+    // Binary column store (see ColumnStore.h). LoadSeriesFromBinary maps the
+    // file and returns a zero-copy view; ConvertCSVToBinary builds a store
+    // from an existing CSV file.
+    PriceSeries LoadSeriesFromBinary(const std::string& filepath);
+    bool ConvertCSVToBinary(const std::string& csvPath, const std::string& binaryPath);
+
+    // Local fallback used when the API is unavailable: prefers
+    // <ticker>.scol and falls back to <ticker>.csv
+    PriceSeries LoadLocalSeries(const std::string& ticker);
+
+    // Batch loaders: run the matching single-series loader for every entry
+    // concurrently on up to `maxWorkers` threads (0 = one per core)
+    std::vector<BatchLoadResult> LoadBatchFromCSV(const std::vector<std::string>& filepaths,
+                                                  size_t maxWorkers = 0);
+    std::vector<BatchLoadResult> LoadBatchFromAPI(const std::vector<std::string>& tickers,
+                                                  const std::string& startDate,
+                                                  const std::string& endDate,
+                                                  size_t maxWorkers = 0);
+    std::vector<BatchLoadResult> LoadBatchLocal(const std::vector<std::string>& tickers,
+                                                size_t maxWorkers = 0);
+
+    // Asynchronous batch API: every request is issued at once through a
+    // single curl multi event loop (see FetchEngine), so N tickers cost
+    // roughly one round-trip instead of N. Results are in input order.
+    // `error` is set only when a request or its parsing fails; a range
+    // the API has no bars for comes back as empty data with no error.
+    std::vector<BatchLoadResult> FetchHistories(const std::vector<std::string>& tickers,
+                                                const std::string& startDate,
+                                                const std::string& endDate);
+    std::vector<LiveQuote> FetchQuotes(const std::vector<std::string>& tickers);
+
+    // FetchHistories through the history cache when one is set
+    std::vector<BatchLoadResult> LoadHistories(const std::vector<std::string>& tickers,
+                                               const std::string& startDate,
+                                               const std::string& endDate);
+
+    // Multi-symbol quotes from the v7 quote endpoint, `symbolsPerRequest`
+    // symbols per request (0 = all in one). Returns one quote per symbol
+    // the API knew, in response order; unknown symbols are left out.
+    std::vector<LiveQuote> FetchQuoteBatch(const std::vector<std::string>& symbols,
+                                           size_t symbolsPerRequest = 50);
+
 private:
-    std::vector<StockData> ParseCSV(const std::string& csvContent);
+    std::string HistoryURL(const std::string& ticker,
+                           const std::string& startDate,
+                           const std::string& endDate) const;
+    std::string QuoteURL(const std::string& ticker) const;
+    std::string QuoteBatchURL(const std::vector<std::string>& symbols) const;
+    PriceSeries ParseChartJSON(const std::string& jsonContent, const std::string& ticker);
+    FetchEngine& Engine();
+
     std::string FetchFromURL(const std::string& url);
     LiveQuote ParseQuoteJSON(const std::string& jsonContent, const std::string& ticker);
+
+    std::shared_ptr<HttpClient> http;
+    std::string baseURL = "https://query1.finance.yahoo.com";
+    HistorySource historySource = CsvDownload;
+
+    std::mutex engineMutex;
+    std::unique_ptr<FetchEngine> engine;  // created on first batch fetch
+    size_t fetchMaxInFlight = 32;
+    size_t fetchMaxPerHost = 6;
+    std::shared_ptr<HttpFixtures> fixtures;
+    std::shared_ptr<HistoryCache> historyCache;
 };
@@ -0,0 +1,318 @@
+#include "StreamingIndicators.h"
+#include <algorithm>
+#include <cmath>
+
+WindowBuffer::WindowBuffer(size_t windowCapacity)
+    : capacity(std::max<size_t>(1, windowCapacity)), values(2 * capacity, 0.0) {
+}
+
+void WindowBuffer::Push(double value) {
+    size_t slot = pushed % capacity;
+    values[slot] = value;
+    values[slot + capacity] = value;
+    ++pushed;
+}
+
+StreamingSMA::StreamingSMA(int smaPeriod)
+    : period(smaPeriod), window(static_cast<size_t>(std::max(0, smaPeriod)) + 1) {
+}
+
+void StreamingSMA::Seed(const PriceSeries& history) {
+    Reset();
+    for (size_t i = 0; i < history.size(); ++i) {
+        Update(history.close[i]);
+    }
+}
+
+bool StreamingSMA::Update(double close) {
+    previous = state;
+    Apply(close);
+    return Ready();
+}
+
+bool StreamingSMA::Revise(double close) {
+    if (state.count == 0) {
+        return Update(close);
+    }
+    state = previous;
+    window.Pop();
+    Apply(close);
+    return Ready();
+}
+
+void StreamingSMA::Reset() {
+    state = State();
+    previous = State();
+    window.Clear();
+}
+
+void StreamingSMA::Apply(double close) {
+    // Same sequence of compensated adds as CalculateSMA
+    window.Push(close);
+    if (period > 0) {
+        CompensatedAdd(state.sum, state.compensation, close);
+        if (state.count >= static_cast<size_t>(period)) {
+            CompensatedAdd(state.sum, state.compensation, -window.Back(period));
+        }
+    }
+    ++state.count;
+}
+
+StreamingEMA::StreamingEMA(int emaPeriod)
+    : period(emaPeriod), multiplier(2.0 / (emaPeriod + 1.0)) {
+}
+
+void StreamingEMA::Seed(const PriceSeries& history) {
+    Reset();
+    for (size_t i = 0; i < history.size(); ++i) {
+        Update(history.close[i]);
+    }
+}
+
+bool StreamingEMA::Update(double close) {
+    previous = state;
+    Apply(close);
+    return Ready();
+}
+
+bool StreamingEMA::Revise(double close) {
+    if (state.count == 0) {
+        return Update(close);
+    }
+    state = previous;
+    Apply(close);
+    return Ready();
+}
+
+void StreamingEMA::Reset() {
+    state = State();
+    previous = State();
+}
+
+void StreamingEMA::Apply(double close) {
+    state.value = state.count == 0 ? close : (close - state.value) * multiplier + state.value;
+    ++state.count;
+}
+
+StreamingRSI::StreamingRSI(int rsiPeriod) : period(rsiPeriod) {
+}
+
+void StreamingRSI::Seed(const PriceSeries& history) {
+    Reset();
+    for (size_t i = 0; i < history.size(); ++i) {
+        Update(history.close[i]);
+    }
+}
+
+bool StreamingRSI::Update(double close) {
+    previous = state;
+    Apply(close);
+    return Ready();
+}
+
+bool StreamingRSI::Revise(double close) {
+    if (state.count == 0) {
+        return Update(close);
+    }
+    state = previous;
+    Apply(close);
+    return Ready();
+}
+
+void StreamingRSI::Reset() {
+    state = State();
+    previous = State();
+}
+
+void StreamingRSI::Apply(double close) {
+    if (state.count > 0 && period > 0) {
+        size_t change = state.count - 1;  // index of this price change
+        double delta = close - state.lastClose;
+        double gain = delta > 0 ? delta : 0.0;
+        double loss = delta < 0 ? -delta : 0.0;
+
+        if (change < static_cast<size_t>(period)) {
+            // Initial averages are plain means of the first `period` changes
+            state.gainSum += gain;
+            state.lossSum += loss;
+            if (change + 1 == static_cast<size_t>(period)) {
+                state.avgGain = state.gainSum / period;
+                state.avgLoss = state.lossSum / period;
+            }
+        } else {
+            state.avgGain = (state.avgGain * (period - 1) + gain) / period;
+            state.avgLoss = (state.avgLoss * (period - 1) + loss) / period;
+            if (state.avgLoss == 0.0) {
+                state.value = 100.0;
+            } else {
+                double rs = state.avgGain / state.avgLoss;
+                state.value = 100.0 - (100.0 / (1.0 + rs));
+            }
+        }
+    }
+    state.lastClose = close;
+    ++state.count;
+}
+
+StreamingMACD::StreamingMACD(int fastLength, int slowLength, int signalLength)
+    : fastPeriod(fastLength),
+      slowPeriod(slowLength),
+      signalPeriod(signalLength),
+      signalMultiplier(2.0 / (signalLength + 1.0)),
+      fast(fastLength),
+      slow(slowLength) {
+}
+
+bool StreamingMACD::Ready() const {
+    return fastPeriod > 0 && slowPeriod > 0 &&
+           state.count >= static_cast<size_t>(slowPeriod + signalPeriod);
+}
+
+void StreamingMACD::Seed(const PriceSeries& history) {
+    Reset();
+    for (size_t i = 0; i < history.size(); ++i) {
+        Update(history.close[i]);
+    }
+}
+
+bool StreamingMACD::Update(double close) {
+    previous = state;
+    fast.Update(close);
+    slow.Update(close);
+    Advance();
+    return Ready();
+}
+
+bool StreamingMACD::Revise(double close) {
+    if (state.count == 0) {
+        return Update(close);
+    }
+    state = previous;
+    fast.Revise(close);
+    slow.Revise(close);
+    Advance();
+    return Ready();
+}
+
+void StreamingMACD::Reset() {
+    state = State();
+    previous = State();
+    fast.Reset();
+    slow.Reset();
+}
+
+void StreamingMACD::Advance() {
+    // The signal line is an EMA over the MACD values themselves
+    double macd = MACD();
+    state.signal = state.count == 0 ? macd : (macd - state.signal) * signalMultiplier + state.signal;
+    ++state.count;
+}
+
+StreamingBollinger::StreamingBollinger(int period, double multiplier)
+    : stdDevMultiplier(multiplier), middle(period) {
+}
+
+void StreamingBollinger::Seed(const PriceSeries& history) {
+    Reset();
+    for (size_t i = 0; i < history.size(); ++i) {
+        Update(history.close[i]);
+    }
+}
+
+bool StreamingBollinger::Update(double close) {
+    previousStats = stats;
+    middle.Update(close);
+    Advance();
+    return Ready();
+}
+
+bool StreamingBollinger::Revise(double close) {
+    if (middle.Count() == 0) {
+        return Update(close);
+    }
+    stats = previousStats;
+    middle.Revise(close);
+    Advance();
+    return Ready();
+}
+
+void StreamingBollinger::Reset() {
+    middle.Reset();
+    stats.Clear();
+    previousStats.Clear();
+}
+
+void StreamingBollinger::Advance() {
+    if (!middle.Ready()) {
+        return;
+    }
+    // Same slide-and-rebuild sequence as CalculateBollingerBands
+    size_t period = static_cast<size_t>(middle.Period());
+    if (middle.Count() == period) {
+        stats.Rebuild(middle.Window(), period);
+        return;
+    }
+    stats.Slide(middle.Window()[period - 1], middle.Dropped());
+    if (stats.NeedsRebuild()) {
+        stats.Rebuild(middle.Window(), period);
+    }
+}
+
+StreamingVolatility::StreamingVolatility(int volatilityWindow)
+    : window(volatilityWindow), returns(static_cast<size_t>(std::max(0, volatilityWindow)) + 1) {
+}
+
+double StreamingVolatility::Value() const {
+    return state.stats.StdDev() * std::sqrt(252.0);
+}
+
+void StreamingVolatility::Seed(const PriceSeries& history) {
+    Reset();
+    for (size_t i = 0; i < history.size(); ++i) {
+        Update(history.close[i]);
+    }
+}
+
+bool StreamingVolatility::Update(double close) {
+    previous = state;
+    Apply(close);
+    return Ready();
+}
+
+bool StreamingVolatility::Revise(double close) {
+    if (state.count == 0) {
+        return Update(close);
+    }
+    state = previous;
+    if (state.count > 0 && window > 0) {
+        returns.Pop();  // the revised bar had pushed a return
+    }
+    Apply(close);
+    return Ready();
+}
+
+void StreamingVolatility::Reset() {
+    state = State();
+    previous = State();
+    returns.Clear();
+}
+
+void StreamingVolatility::Apply(double close) {
+    if (state.count > 0 && window > 0) {
+        returns.Push((close - state.lastClose) / state.lastClose);
+
+        // Same slide-and-rebuild sequence as CalculateVolatility
+        size_t count = state.count;  // returns so far, including this one
+        size_t size = static_cast<size_t>(window);
+        if (count == size) {
+            state.stats.Rebuild(returns.Newest(size), size);
+        } else if (count > size) {
+            state.stats.Slide(returns.Back(0), returns.Back(size));
+            if (state.stats.NeedsRebuild()) {
+                state.stats.Rebuild(returns.Newest(size), size);
+            }
+        }
+    }
+    state.lastClose = close;
+    ++state.count;
+}
@@ -0,0 +1,223 @@
+#pragma once
+#include "PriceSeries.h"
+#include "RollingStats.h"
+#include <cstddef>
+#include <vector>
+
+// Incremental versions of the DataProcessor indicators for live data.
+//
+// Each indicator is seeded once from history and then advanced one close at
+// a time in O(1), without going back over the series. After any sequence of
+// calls, Value() (or the named accessors) is bit-identical to the last
+// element the batch function would return for the same closes; Ready() is
+// false exactly when the batch function would return nothing.
+//
+//   StreamingRSI rsi(14);
+//   rsi.Seed(history);                    // O(n), once
+//   rsi.Update(quote.currentPrice);       // a new session's bar
+//   rsi.Revise(quote.currentPrice);       // later ticks of the same bar
+//
+// Update appends a bar. Revise replaces the close of the newest bar, which
+// is how intraday quotes from StockDataLoader::GetLatestQuote are applied:
+// the session's bar keeps changing until it closes, and the next session
+// starts with Update again. Revise before any Update is treated as Update.
+
+// Last `capacity` values of a stream, laid out so that any suffix is
+// contiguous in oldest-to-newest order (every value is written twice, one
+// capacity apart). Used for the windows that must be rescanned exactly.
+class WindowBuffer {
+public:
+    explicit WindowBuffer(size_t capacity);
+
+    void Push(double value);
+    // Forgets the newest value, so the next Push replaces it
+    void Pop() { --pushed; }
+    void Clear() { pushed = 0; }
+
+    // Value pushed `age` pushes ago (0 = newest); age < capacity
+    double Back(size_t age) const { return values[(pushed - 1 - age) % capacity]; }
+    // The newest `n` values, oldest first; n <= capacity
+    const double* Newest(size_t n) const { return &values[(pushed - n) % capacity]; }
+
+private:
+    size_t capacity;
+    size_t pushed = 0;
+    std::vector<double> values;  // 2 * capacity
+};
+
+// Matches DataProcessor::CalculateSMA
+class StreamingSMA {
+public:
+    explicit StreamingSMA(int period);
+
+    void Seed(const PriceSeries& history);
+    bool Update(double close);
+    bool Revise(double close);
+    void Reset();
+
+    bool Ready() const { return period > 0 && state.count >= static_cast<size_t>(period); }
+    double Value() const { return (state.sum + state.compensation) / period; }
+    int Period() const { return period; }
+    size_t Count() const { return state.count; }
+    // The last Period() closes, oldest first (valid once Ready)
+    const double* Window() const { return window.Newest(period); }
+    // The close that left the window on the newest update (Count() > Period())
+    double Dropped() const { return window.Back(period); }
+
+private:
+    void Apply(double close);
+
+    struct State {
+        size_t count = 0;
+        double sum = 0.0;
+        double compensation = 0.0;
+    };
+
+    int period;
+    WindowBuffer window;  // one close more than the period: the one leaving
+    State state;
+    State previous;       // before the newest close, for Revise
+};
+
+// Matches DataProcessor::CalculateEMA
+class StreamingEMA {
+public:
+    explicit StreamingEMA(int period);
+
+    void Seed(const PriceSeries& history);
+    bool Update(double close);
+    bool Revise(double close);
+    void Reset();
+
+    bool Ready() const { return period > 0 && state.count > 0; }
+    double Value() const { return state.value; }
+
+private:
+    void Apply(double close);
+
+    struct State {
+        size_t count = 0;
+        double value = 0.0;
+    };
+
+    int period;
+    double multiplier;
+    State state;
+    State previous;
+};
+
+// Matches DataProcessor::CalculateRSI (Wilder smoothing)
+class StreamingRSI {
+public:
+    explicit StreamingRSI(int period = 14);
+
+    void Seed(const PriceSeries& history);
+    bool Update(double close);
+    bool Revise(double close);
+    void Reset();
+
+    bool Ready() const { return period > 0 && state.count >= static_cast<size_t>(period) + 2; }
+    double Value() const { return state.value; }
+
+private:
+    void Apply(double close);
+
+    struct State {
+        size_t count = 0;
+        double lastClose = 0.0;
+        double gainSum = 0.0;
+        double lossSum = 0.0;
+        double avgGain = 0.0;
+        double avgLoss = 0.0;
+        double value = 0.0;
+    };
+
+    int period;
+    State state;
+    State previous;
+};
+
+// Matches DataProcessor::CalculateMACD
+class StreamingMACD {
+public:
+    StreamingMACD(int fastPeriod = 12, int slowPeriod = 26, int signalPeriod = 9);
+
+    void Seed(const PriceSeries& history);
+    bool Update(double close);
+    bool Revise(double close);
+    void Reset();
+
+    bool Ready() const;
+    double MACD() const { return fast.Value() - slow.Value(); }
+    double Signal() const { return state.signal; }
+    double Histogram() const { return MACD() - state.signal; }
+
+private:
+    void Advance();
+
+    struct State {
+        size_t count = 0;
+        double signal = 0.0;
+    };
+
+    int fastPeriod;
+    int slowPeriod;
+    int signalPeriod;
+    double signalMultiplier;
+    StreamingEMA fast;
+    StreamingEMA slow;
+    State state;
+    State previous;
+};
+
+// Matches DataProcessor::CalculateBollingerBands
+class StreamingBollinger {
+public:
+    explicit StreamingBollinger(int period = 20, double stdDevMultiplier = 2.0);
+
+    void Seed(const PriceSeries& history);
+    bool Update(double close);
+    bool Revise(double close);
+    void Reset();
+
+    bool Ready() const { return middle.Ready(); }
+    double Middle() const { return middle.Value(); }
+    double Upper() const { return middle.Value() + stdDevMultiplier * stats.StdDev(); }
+    double Lower() const { return middle.Value() - stdDevMultiplier * stats.StdDev(); }
+
+private:
+    void Advance();
+
+    double stdDevMultiplier;
+    StreamingSMA middle;
+    RollingStats stats;
+    RollingStats previousStats;
+};
+
+// Matches DataProcessor::CalculateVolatility (annualized)
+class StreamingVolatility {
+public:
+    explicit StreamingVolatility(int window = 20);
+
+    void Seed(const PriceSeries& history);
+    bool Update(double close);
+    bool Revise(double close);
+    void Reset();
+
+    bool Ready() const { return window > 0 && state.count >= static_cast<size_t>(window) + 1; }
+    double Value() const;
+
+private:
+    void Apply(double close);
+
+    struct State {
+        size_t count = 0;
+        double lastClose = 0.0;
+        RollingStats stats;
+    };
+
+    int window;
+    WindowBuffer returns;  // one return more than the window
+    State state;
+    State previous;
+};
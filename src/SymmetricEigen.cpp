@@ -0,0 +1,298 @@
+#include "SymmetricEigen.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+
+#ifdef USE_EIGEN
+#include <Eigen/Dense>
+#endif
+
+namespace {
+
+// Iteration cap per eigenvalue for the QL sweep; convergence normally takes
+// two or three
+const int MaxQLIterations = 60;
+
+#ifndef USE_EIGEN
+
+// Householder reduction of the symmetric matrix in `v` (n x n, row-major) to
+// tridiagonal form: on return d holds the diagonal, e the subdiagonal (in
+// e[1..n-1]) and v the accumulated orthogonal transformation
+void Tridiagonalize(std::vector<double>& v, std::vector<double>& d, std::vector<double>& e, int n) {
+    auto V = [&v, n](int row, int col) -> double& { return v[static_cast<size_t>(row) * n + col]; };
+
+    for (int j = 0; j < n; ++j) {
+        d[j] = V(n - 1, j);
+    }
+    for (int i = n - 1; i > 0; --i) {
+        // Scale to avoid under/overflow
+        double scale = 0.0;
+        double h = 0.0;
+        for (int k = 0; k < i; ++k) {
+            scale += std::fabs(d[k]);
+        }
+        if (scale == 0.0) {
+            e[i] = d[i - 1];
+            for (int j = 0; j < i; ++j) {
+                d[j] = V(i - 1, j);
+                V(i, j) = 0.0;
+                V(j, i) = 0.0;
+            }
+        } else {
+            // Householder vector
+            for (int k = 0; k < i; ++k) {
+                d[k] /= scale;
+                h += d[k] * d[k];
+            }
+            double f = d[i - 1];
+            double g = std::sqrt(h);
+            if (f > 0) {
+                g = -g;
+            }
+            e[i] = scale * g;
+            h -= f * g;
+            d[i - 1] = f - g;
+            for (int j = 0; j < i; ++j) {
+                e[j] = 0.0;
+            }
+
+            // Apply the similarity transformation to the remaining columns
+            for (int j = 0; j < i; ++j) {
+                f = d[j];
+                V(j, i) = f;
+                g = e[j] + V(j, j) * f;
+                for (int k = j + 1; k <= i - 1; ++k) {
+                    g += V(k, j) * d[k];
+                    e[k] += V(k, j) * f;
+                }
+                e[j] = g;
+            }
+            f = 0.0;
+            for (int j = 0; j < i; ++j) {
+                e[j] /= h;
+                f += e[j] * d[j];
+            }
+            double hh = f / (h + h);
+            for (int j = 0; j < i; ++j) {
+                e[j] -= hh * d[j];
+            }
+            for (int j = 0; j < i; ++j) {
+                f = d[j];
+                g = e[j];
+                for (int k = j; k <= i - 1; ++k) {
+                    V(k, j) -= (f * e[k] + g * d[k]);
+                }
+                d[j] = V(i - 1, j);
+                V(i, j) = 0.0;
+            }
+        }
+        d[i] = h;
+    }
+
+    // Accumulate the transformations
+    for (int i = 0; i < n - 1; ++i) {
+        V(n - 1, i) = V(i, i);
+        V(i, i) = 1.0;
+        double h = d[i + 1];
+        if (h != 0.0) {
+            for (int k = 0; k <= i; ++k) {
+                d[k] = V(k, i + 1) / h;
+            }
+            for (int j = 0; j <= i; ++j) {
+                double g = 0.0;
+                for (int k = 0; k <= i; ++k) {
+                    g += V(k, i + 1) * V(k, j);
+                }
+                for (int k = 0; k <= i; ++k) {
+                    V(k, j) -= g * d[k];
+                }
+            }
+        }
+        for (int k = 0; k <= i; ++k) {
+            V(k, i + 1) = 0.0;
+        }
+    }
+    for (int j = 0; j < n; ++j) {
+        d[j] = V(n - 1, j);
+        V(n - 1, j) = 0.0;
+    }
+    V(n - 1, n - 1) = 1.0;
+    e[0] = 0.0;
+}
+
+// Implicit QL iterations on the tridiagonal matrix (d, e). `w` holds the
+// transformation from Tridiagonalize transposed (row k = column k), so each
+// rotation updates two contiguous rows. On return d holds the eigenvalues
+// and row k of w the eigenvector of d[k].
+bool DiagonalizeTridiagonal(std::vector<double>& w, std::vector<double>& d, std::vector<double>& e, int n) {
+    auto row = [&w, n](int k) { return &w[static_cast<size_t>(k) * n]; };
+
+    for (int i = 1; i < n; ++i) {
+        e[i - 1] = e[i];
+    }
+    e[n - 1] = 0.0;
+
+    double f = 0.0;
+    double tst1 = 0.0;
+    const double eps = std::ldexp(1.0, -52);
+    for (int l = 0; l < n; ++l) {
+        // Find a small subdiagonal element
+        tst1 = std::max(tst1, std::fabs(d[l]) + std::fabs(e[l]));
+        int m = l;
+        while (m < n - 1 && std::fabs(e[m]) > eps * tst1) {
+            ++m;
+        }
+
+        // If m == l, d[l] is already an eigenvalue; otherwise iterate
+        int iterations = 0;
+        while (m > l) {
+            if (++iterations > MaxQLIterations) {
+                return false;
+            }
+
+            // Implicit shift
+            double g = d[l];
+            double p = (d[l + 1] - g) / (2.0 * e[l]);
+            double r = std::hypot(p, 1.0);
+            if (p < 0) {
+                r = -r;
+            }
+            d[l] = e[l] / (p + r);
+            d[l + 1] = e[l] * (p + r);
+            double dl1 = d[l + 1];
+            double h = g - d[l];
+            for (int i = l + 2; i < n; ++i) {
+                d[i] -= h;
+            }
+            f += h;
+
+            // Implicit QL transformation
+            p = d[m];
+            double c = 1.0, c2 = 1.0, c3 = 1.0;
+            double el1 = e[l + 1];
+            double s = 0.0, s2 = 0.0;
+            for (int i = m - 1; i >= l; --i) {
+                c3 = c2;
+                c2 = c;
+                s2 = s;
+                g = c * e[i];
+                h = c * p;
+                r = std::hypot(p, e[i]);
+                e[i + 1] = s * r;
+                s = e[i] / r;
+                c = p / r;
+                p = c * d[i] - s * g;
+                d[i + 1] = h + s * (c * g + s * d[i]);
+
+                // Accumulate the rotation into eigenvectors i and i + 1
+                double* vi = row(i);
+                double* vi1 = row(i + 1);
+                for (int k = 0; k < n; ++k) {
+                    double t = vi1[k];
+                    vi1[k] = s * vi[k] + c * t;
+                    vi[k] = c * vi[k] - s * t;
+                }
+            }
+            p = -s * s2 * c3 * el1 * e[l] / dl1;
+            e[l] = s * p;
+            d[l] = c * p;
+
+            if (std::fabs(e[l]) <= eps * tst1) {
+                break;
+            }
+        }
+        d[l] += f;
+        e[l] = 0.0;
+    }
+    return true;
+}
+
+#endif // USE_EIGEN
+
+} // namespace
+
+SymmetricEigenResult SymmetricEigen(const std::vector<std::vector<double>>& matrix) {
+    SymmetricEigenResult result;
+    const size_t size = matrix.size();
+    for (const auto& matrixRow : matrix) {
+        if (matrixRow.size() != size) {
+            std::cerr << "Error: Eigen-decomposition needs a square matrix\n";
+            return result;
+        }
+    }
+    if (size == 0) {
+        result.success = true;
+        return result;
+    }
+
+    std::vector<double> values(size);
+    std::vector<std::vector<double>> vectors(size, std::vector<double>(size));
+
+#ifdef USE_EIGEN
+    Eigen::MatrixXd a(size, size);
+    for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            a(i, j) = a(j, i) = matrix[i][j];
+        }
+    }
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(a);
+    if (solver.info() != Eigen::Success) {
+        std::cerr << "Error: Eigen-decomposition did not converge\n";
+        return result;
+    }
+    for (size_t k = 0; k < size; ++k) {
+        values[k] = solver.eigenvalues()(k);
+        for (size_t i = 0; i < size; ++i) {
+            vectors[k][i] = solver.eigenvectors()(i, k);
+        }
+    }
+#else
+    const int n = static_cast<int>(size);
+    std::vector<double> v(size * size);
+    for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            v[i * size + j] = v[j * size + i] = matrix[i][j];
+        }
+    }
+    std::vector<double> d(size), e(size);
+    Tridiagonalize(v, d, e, n);
+
+    // Transpose so that each eigenvector becomes a contiguous row
+    for (size_t i = 0; i < size; ++i) {
+        for (size_t j = i + 1; j < size; ++j) {
+            std::swap(v[i * size + j], v[j * size + i]);
+        }
+    }
+    if (!DiagonalizeTridiagonal(v, d, e, n)) {
+        std::cerr << "Error: Eigen-decomposition did not converge\n";
+        return result;
+    }
+    for (size_t k = 0; k < size; ++k) {
+        values[k] = d[k];
+        std::copy(v.begin() + k * size, v.begin() + (k + 1) * size, vectors[k].begin());
+    }
+#endif
+
+    // Largest eigenvalue first, each vector's largest entry positive
+    std::vector<size_t> order(size);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&values](size_t lhs, size_t rhs) { return values[lhs] > values[rhs]; });
+    result.values.reserve(size);
+    result.vectors.reserve(size);
+    for (size_t k : order) {
+        std::vector<double>& vector = vectors[k];
+        auto largest = std::max_element(vector.begin(), vector.end(),
+                                        [](double lhs, double rhs) { return std::fabs(lhs) < std::fabs(rhs); });
+        if (*largest < 0) {
+            for (double& x : vector) {
+                x = -x;
+            }
+        }
+        result.values.push_back(values[k]);
+        result.vectors.push_back(std::move(vector));
+    }
+    result.success = true;
+    return result;
+}
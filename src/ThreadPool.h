@@ -0,0 +1,76 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed-size worker pool. Tasks run in submission order on at most
+// WorkerCount() threads; Submit returns a future for the task's result.
+// The destructor finishes queued tasks before joining.
+class ThreadPool {
+public:
+    // 0 means one worker per hardware thread
+    explicit ThreadPool(size_t workerCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t WorkerCount() const { return workers.size(); }
+
+    template <typename F>
+    auto Submit(F&& task) -> std::future<decltype(task())> {
+        using Result = decltype(task());
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([packaged]() { (*packaged)(); });
+        }
+        wakeup.notify_one();
+        return future;
+    }
+
+    // Runs body(i) for i in [0, count) across the pool and waits for all.
+    // If calls throw, the first exception is rethrown, but only once every
+    // task has finished (they all reference `body`).
+    template <typename F>
+    void ParallelFor(size_t count, F body) {
+        std::vector<std::future<void>> pending;
+        pending.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            pending.push_back(Submit([&body, i]() { body(i); }));
+        }
+        std::exception_ptr failure;
+        for (auto& task : pending) {
+            try {
+                task.get();
+            } catch (...) {
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+            }
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    // Worker count used when 0 is requested
+    static size_t DefaultWorkerCount();
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopping = false;
+};
@@ -1,4 +1,6 @@
 #include "Visualizer.h"
+#include "DateUtil.h"
+#include "PanelBuilder.h"
 #include <fstream>
 #include <iostream>
 #include <iomanip>
@@ -25,7 +27,7 @@ Visualizer::Visualizer(const std::string& outputDir) : outputDirectory(outputDir
 #endif
 }
 
-bool Visualizer::SaveDataForPlotting(const std::vector<StockData>& data, 
+bool Visualizer::SaveDataForPlotting(const PriceSeries& data, 
                                      const std::string& dataFile) {
     std::ofstream file(dataFile);
     if (!file.is_open()) {
@@ -34,15 +36,15 @@ bool Visualizer::SaveDataForPlotting(const std::vector<StockData>& data,
     }
     
     file << "Date,Open,High,Low,Close,Volume\n";
-    for (const auto& d : data) {
-        file << d.date << "," << d.open << "," << d.high << "," 
-             << d.low << "," << d.close << "," << d.volume << "\n";
+    for (size_t i = 0; i < data.size(); ++i) {
+        file << DateUtil::FormatDate(data.date[i]) << "," << data.open[i] << "," << data.high[i] << "," 
+             << data.low[i] << "," << data.close[i] << "," << data.volume[i] << "\n";
     }
     file.close();
     return true;
 }
 
-bool Visualizer::PlotPriceTrend(const std::vector<StockData>& data, 
+bool Visualizer::PlotPriceTrend(const PriceSeries& data, 
                                 const std::string& ticker,
                                 const std::string& filename) {
     std::string outputFile = filename.empty() 
@@ -62,7 +64,7 @@ bool Visualizer::PlotPriceTrend(const std::vector<StockData>& data,
     return true;
 }
 
-bool Visualizer::PlotWithMovingAverages(const std::vector<StockData>& data,
+bool Visualizer::PlotWithMovingAverages(const PriceSeries& data,
                                        const std::vector<double>& sma,
                                        const std::vector<double>& ema,
                                        const std::string& ticker,
@@ -81,7 +83,7 @@ bool Visualizer::PlotWithMovingAverages(const std::vector<StockData>& data,
     file << "Date,Close,SMA,EMA\n";
     size_t maOffset = data.size() - sma.size();
     for (size_t i = 0; i < data.size(); ++i) {
-        file << data[i].date << "," << data[i].close;
+        file << DateUtil::FormatDate(data.date[i]) << "," << data.close[i];
         if (i >= maOffset && (i - maOffset) < sma.size()) {
             size_t maIdx = i - maOffset;
             file << "," << sma[maIdx];
@@ -101,7 +103,7 @@ bool Visualizer::PlotWithMovingAverages(const std::vector<StockData>& data,
     return true;
 }
 
-bool Visualizer::PlotVolatility(const std::vector<StockData>& data,
+bool Visualizer::PlotVolatility(const PriceSeries& data,
                                const std::vector<double>& volatility,
                                const std::string& ticker,
                                const std::string& filename) {
@@ -118,7 +120,7 @@ bool Visualizer::PlotVolatility(const std::vector<StockData>& data,
     file << "Date,Volatility\n";
     size_t volOffset = data.size() - volatility.size();
     for (size_t i = 0; i < data.size(); ++i) {
-        file << data[i].date;
+        file << DateUtil::FormatDate(data.date[i]);
         if (i >= volOffset && (i - volOffset) < volatility.size()) {
             file << "," << volatility[i - volOffset];
         } else {
@@ -132,7 +134,7 @@ bool Visualizer::PlotVolatility(const std::vector<StockData>& data,
     return true;
 }
 
-bool Visualizer::PlotRSI(const std::vector<StockData>& data,
+bool Visualizer::PlotRSI(const PriceSeries& data,
                         const std::vector<double>& rsi,
                         const std::string& ticker,
                         const std::string& filename) {
@@ -149,7 +151,7 @@ bool Visualizer::PlotRSI(const std::vector<StockData>& data,
     file << "Date,RSI\n";
     size_t rsiOffset = data.size() - rsi.size();
     for (size_t i = 0; i < data.size(); ++i) {
-        file << data[i].date;
+        file << DateUtil::FormatDate(data.date[i]);
         if (i >= rsiOffset && (i - rsiOffset) < rsi.size()) {
             file << "," << rsi[i - rsiOffset];
         } else {
@@ -163,7 +165,7 @@ bool Visualizer::PlotRSI(const std::vector<StockData>& data,
     return true;
 }
 
-bool Visualizer::PlotMACD(const std::vector<StockData>& data,
+bool Visualizer::PlotMACD(const PriceSeries& data,
                          const DataProcessor::MACDResult& macd,
                          const std::string& ticker,
                          const std::string& filename) {
@@ -182,7 +184,7 @@ bool Visualizer::PlotMACD(const std::vector<StockData>& data,
     size_t signalOffset = macd.macd.size() - macd.signal.size();
     
     for (size_t i = 0; i < data.size(); ++i) {
-        file << data[i].date;
+        file << DateUtil::FormatDate(data.date[i]);
         
         if (i >= macdOffset && (i - macdOffset) < macd.macd.size()) {
             size_t macdIdx = i - macdOffset;
@@ -210,7 +212,7 @@ bool Visualizer::PlotMACD(const std::vector<StockData>& data,
     return true;
 }
 
-bool Visualizer::PlotBollingerBands(const std::vector<StockData>& data,
+bool Visualizer::PlotBollingerBands(const PriceSeries& data,
                                    const DataProcessor::BollingerBands& bands,
                                    const std::string& ticker,
                                    const std::string& filename) {
@@ -228,7 +230,7 @@ bool Visualizer::PlotBollingerBands(const std::vector<StockData>& data,
     size_t bandsOffset = data.size() - bands.upper.size();
     
     for (size_t i = 0; i < data.size(); ++i) {
-        file << data[i].date << "," << data[i].close;
+        file << DateUtil::FormatDate(data.date[i]) << "," << data.close[i];
         if (i >= bandsOffset && (i - bandsOffset) < bands.upper.size()) {
             size_t bandsIdx = i - bandsOffset;
             file << "," << bands.upper[bandsIdx] 
@@ -248,6 +250,13 @@ bool Visualizer::PlotBollingerBands(const std::vector<StockData>& data,
 bool Visualizer::PlotMultipleStocks(const std::vector<std::vector<StockData>>& stocksData,
                                     const std::vector<std::string>& tickers,
                                     const std::string& filename) {
+    std::vector<PriceSeries> series(stocksData.begin(), stocksData.end());
+    return PlotMultipleStocks(series, tickers, filename);
+}
+
+bool Visualizer::PlotMultipleStocks(const std::vector<PriceSeries>& stocksData,
+                                    const std::vector<std::string>& tickers,
+                                    const std::string& filename) {
     if (stocksData.size() != tickers.size()) {
         std::cerr << "Error: Mismatch between stocks data and tickers\n";
         return false;
@@ -270,23 +279,21 @@ bool Visualizer::PlotMultipleStocks(const std::vector<std::vector<StockData>>& s
     }
     file << "\n";
     
-    // Find max size
-    size_t maxSize = 0;
-    for (const auto& stock : stocksData) {
-        maxSize = std::max(maxSize, stock.size());
+    // One line per date any stock traded; a stock without a bar that day
+    // gets an empty field
+    PanelBuilder builder(JoinPolicy::Outer);
+    for (size_t j = 0; j < stocksData.size(); ++j) {
+        builder.Add(stocksData[j], tickers[j]);
     }
+    Panel closes = builder.Build().WithLayout(Panel::Layout::RowMajor);
     
-    for (size_t i = 0; i < maxSize; ++i) {
-        if (i < stocksData[0].size()) {
-            file << stocksData[0][i].date;
-        } else {
+    for (size_t d = 0; d < closes.Dates(); ++d) {
+        file << DateUtil::FormatDate(closes.DateAxis()[d]);
+        Span<const double> row = closes.Row(d).Contiguous();
+        for (size_t j = 0; j < row.size(); ++j) {
             file << ",";
-        }
-        
-        for (size_t j = 0; j < stocksData.size(); ++j) {
-            file << ",";
-            if (i < stocksData[j].size()) {
-                file << stocksData[j][i].close;
+            if (closes.IsValid(d, j)) {
+                file << row[j];
             }
         }
         file << "\n";
@@ -297,7 +304,7 @@ bool Visualizer::PlotMultipleStocks(const std::vector<std::vector<StockData>>& s
     return true;
 }
 
-void Visualizer::PrintConsoleSummary(const std::vector<StockData>& data, 
+void Visualizer::PrintConsoleSummary(const PriceSeries& data, 
                                      const std::string& ticker) {
     if (data.empty()) {
         std::cout << "No data available for " << ticker << "\n";
@@ -305,29 +312,30 @@ void Visualizer::PrintConsoleSummary(const std::vector<StockData>& data,
     }
     
     std::cout << "\n=== Stock Summary: " << ticker << " ===\n";
-    std::cout << "Date Range: " << data.front().date << " to " << data.back().date << "\n";
+    std::cout << "Date Range: " << DateUtil::FormatDate(data.date.front()) << " to "
+              << DateUtil::FormatDate(data.date.back()) << "\n";
     std::cout << "Total Days: " << data.size() << "\n";
     
-    double minPrice = data[0].low;
-    double maxPrice = data[0].high;
+    double minPrice = data.low[0];
+    double maxPrice = data.high[0];
     double totalVolume = 0.0;
     
-    for (const auto& d : data) {
-        minPrice = std::min(minPrice, d.low);
-        maxPrice = std::max(maxPrice, d.high);
-        totalVolume += d.volume;
+    for (size_t i = 0; i < data.size(); ++i) {
+        minPrice = std::min(minPrice, data.low[i]);
+        maxPrice = std::max(maxPrice, data.high[i]);
+        totalVolume += data.volume[i];
     }
     
     std::cout << std::fixed << std::setprecision(2);
     std::cout << "Lowest Price: $" << minPrice << "\n";
     std::cout << "Highest Price: $" << maxPrice << "\n";
-    std::cout << "Current Close: $" << data.back().close << "\n";
+    std::cout << "Current Close: $" << data.close.back() << "\n";
     std::cout << "Average Volume: " << std::setprecision(0) 
               << totalVolume / data.size() << "\n";
     std::cout << "========================\n\n";
 }
 
-bool Visualizer::GenerateHTMLReport(const std::vector<StockData>& data,
+bool Visualizer::GenerateHTMLReport(const PriceSeries& data,
                                    const std::vector<double>& sma,
                                    const std::vector<double>& volatility,
                                    const std::string& ticker,
@@ -347,7 +355,8 @@ bool Visualizer::GenerateHTMLReport(const std::vector<StockData>& data,
     file << "</head><body>\n";
     file << "<h1>StockSense Report: " << ticker << "</h1>\n";
     file << "<h2>Summary</h2>\n";
-    file << "<p>Date Range: " << data.front().date << " to " << data.back().date << "</p>\n";
+    file << "<p>Date Range: " << DateUtil::FormatDate(data.date.front()) << " to "
+         << DateUtil::FormatDate(data.date.back()) << "</p>\n";
     file << "<p>Total Data Points: " << data.size() << "</p>\n";
     
     file << "<h2>Recent Data</h2>\n";
@@ -355,9 +364,9 @@ bool Visualizer::GenerateHTMLReport(const std::vector<StockData>& data,
     
     size_t rowsToShow = std::min(static_cast<size_t>(20), data.size());
     for (size_t i = data.size() - rowsToShow; i < data.size(); ++i) {
-        file << "<tr><td>" << data[i].date << "</td><td>$" << data[i].open 
-             << "</td><td>$" << data[i].high << "</td><td>$" << data[i].low 
-             << "</td><td>$" << data[i].close << "</td><td>" << data[i].volume << "</td></tr>\n";
+        file << "<tr><td>" << DateUtil::FormatDate(data.date[i]) << "</td><td>$" << data.open[i] 
+             << "</td><td>$" << data.high[i] << "</td><td>$" << data.low[i] 
+             << "</td><td>$" << data.close[i] << "</td><td>" << data.volume[i] << "</td></tr>\n";
     }
     file << "</table>\n";
     file << "</body></html>\n";
@@ -375,7 +384,7 @@ bool Visualizer::PlotWithGnuplot(const std::string& dataFile,
     return false;
 }
 
-bool Visualizer::PlotWithMatplotlib(const std::vector<StockData>& data,
+bool Visualizer::PlotWithMatplotlib(const PriceSeries& data,
                                    const std::string& outputFile,
                                    const std::string& title) {
     // TODO: Implement matplotlib-cpp integration
@@ -0,0 +1,37 @@
+#include "StockDataLoader.h"
+#include <iostream>
+#include <string>
+
+// Converts CSV price files into the binary column store format.
+// Usage: StockSenseConvert AAPL.csv [MSFT.csv ...]
+// Each input is written next to itself with a .scol extension.
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file.csv> [file.csv ...]\n";
+        return 1;
+    }
+
+    StockDataLoader loader;
+    int failures = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string csvPath = argv[i];
+        std::string binaryPath = csvPath;
+        size_t lastDot = binaryPath.find_last_of('.');
+        size_t lastSlash = binaryPath.find_last_of("/\\");
+        if (lastDot != std::string::npos &&
+            (lastSlash == std::string::npos || lastDot > lastSlash)) {
+            binaryPath = binaryPath.substr(0, lastDot);
+        }
+        binaryPath += ".scol";
+
+        if (loader.ConvertCSVToBinary(csvPath, binaryPath)) {
+            std::cout << csvPath << " -> " << binaryPath << "\n";
+        } else {
+            std::cerr << "Failed to convert " << csvPath << "\n";
+            ++failures;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -1,7 +1,12 @@
 #include "StockDataLoader.h"
 #include "DataProcessor.h"
+#include "IndicatorGraph.h"
 #include "Visualizer.h"
+#include "Config.h"
+#include "HistoryCache.h"
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 #include <iomanip>
@@ -21,6 +26,31 @@ void PrintMenu() {
     std::cout << "Enter your choice: ";
 }
 
+// The report indicators from config.json, prefetched into an IndicatorGraph
+// in one fused pass; the first SMA and EMA are plotted
+DataProcessor::IndicatorSet ReportIndicators() {
+    const Config& config = Config::GetInstance();
+    DataProcessor::IndicatorSet indicators;
+    indicators.smaPeriods = config.GetSMAPeriods();
+    if (indicators.smaPeriods.empty()) {
+        indicators.smaPeriods.push_back(20);
+    }
+    indicators.emaPeriods = config.GetEMAPeriods();
+    if (indicators.emaPeriods.empty()) {
+        indicators.emaPeriods.push_back(20);
+    }
+    indicators.returns = true;
+    indicators.volatilityWindow = config.GetVolatilityWindow();
+    indicators.rsiPeriod = config.GetRSIPeriod();
+    indicators.macd = true;
+    indicators.macdFast = config.GetMACDFast();
+    indicators.macdSlow = config.GetMACDSlow();
+    indicators.macdSignal = config.GetMACDSignal();
+    indicators.bollingerPeriod = config.GetBollingerPeriod();
+    indicators.bollingerStd = config.GetBollingerStd();
+    return indicators;
+}
+
 void AnalyzeSingleStock(StockDataLoader& loader, DataProcessor& processor, Visualizer& visualizer) {
     std::string ticker;
     std::string startDate, endDate;
@@ -36,11 +66,11 @@ void AnalyzeSingleStock(StockDataLoader& loader, DataProcessor& processor, Visua
     std::cin >> endDate;
     
     std::cout << "\nFetching data for " << ticker << "...\n";
-    auto data = loader.LoadFromAPI(ticker, startDate, endDate);
+    auto data = loader.LoadSeriesFromAPI(ticker, startDate, endDate);
     
     if (data.empty()) {
-        std::cout << "API fetch failed. Trying CSV file...\n";
-        data = loader.LoadFromCSV(ticker + ".csv");
+        std::cout << "API fetch failed. Trying local files...\n";
+        data = loader.LoadLocalSeries(ticker);
     }
     
     if (data.empty()) {
@@ -52,14 +82,16 @@ void AnalyzeSingleStock(StockDataLoader& loader, DataProcessor& processor, Visua
     
     // Calculate all indicators
     std::cout << "\nCalculating indicators...\n";
-    auto sma20 = processor.CalculateSMA(data, 20);
-    auto sma50 = processor.CalculateSMA(data, 50);
-    auto ema20 = processor.CalculateEMA(data, 20);
-    auto volatility = processor.CalculateRollingVolatility(data, 20);
-    auto rsi = processor.CalculateRSI(data, 14);
-    auto macd = processor.CalculateMACD(data);
-    auto bollinger = processor.CalculateBollingerBands(data, 20, 2.0);
-    auto returns = processor.CalculateReturns(data);
+    DataProcessor::IndicatorSet indicators = ReportIndicators();
+    IndicatorGraph graph(data);
+    graph.Prefetch(indicators);
+    const auto& sma = graph.Get({IndicatorKey::SMA, indicators.smaPeriods.front()});
+    const auto& ema = graph.Get({IndicatorKey::EMA, indicators.emaPeriods.front()});
+    const auto& volatility = graph.Get({IndicatorKey::Volatility, indicators.volatilityWindow});
+    const auto& rsi = graph.Get({IndicatorKey::RSI, indicators.rsiPeriod});
+    const auto& macd = graph.MACD(indicators.macdFast, indicators.macdSlow, indicators.macdSignal);
+    const auto& bollinger = graph.Bollinger(indicators.bollingerPeriod, indicators.bollingerStd);
+    const auto& returns = graph.Get({IndicatorKey::Returns});
     
     // Print summary
     visualizer.PrintConsoleSummary(data, ticker);
@@ -77,22 +109,66 @@ void AnalyzeSingleStock(StockDataLoader& loader, DataProcessor& processor, Visua
         if (rsi.back() > 70) std::cout << "  -> Overbought\n";
         else if (rsi.back() < 30) std::cout << "  -> Oversold\n";
     }
+    for (int period : indicators.smaPeriods) {
+        const auto& values = graph.Get({IndicatorKey::SMA, period});
+        if (!values.empty()) {
+            std::cout << "SMA(" << period << "): " << values.back() << "\n";
+        }
+    }
     
     // Generate visualizations
     std::cout << "\nGenerating visualizations...\n";
     visualizer.PlotPriceTrend(data, ticker);
-    visualizer.PlotWithMovingAverages(data, sma20, ema20, ticker);
+    visualizer.PlotWithMovingAverages(data, sma, ema, ticker);
     visualizer.PlotVolatility(data, volatility, ticker);
     visualizer.PlotRSI(data, rsi, ticker);
     visualizer.PlotMACD(data, macd, ticker);
     visualizer.PlotBollingerBands(data, bollinger, ticker);
     
     // Generate HTML report
-    visualizer.GenerateHTMLReport(data, sma20, volatility, ticker);
+    visualizer.GenerateHTMLReport(data, sma, volatility, ticker);
     
     std::cout << "\nAnalysis complete! Check the 'output' directory for results.\n";
 }
 
+// Loads all tickers concurrently: the API first, then local files for any
+// that failed. Tickers that loaded are appended, in input order, to
+// `tickers` and `stocksData`.
+void LoadTickers(StockDataLoader& loader, const std::vector<std::string>& requested,
+                 const std::string& startDate, const std::string& endDate,
+                 std::vector<std::string>& tickers, std::vector<PriceSeries>& stocksData) {
+    size_t workers = static_cast<size_t>(Config::GetInstance().GetLoaderThreads());
+    
+    std::cout << "Fetching " << requested.size() << " tickers...\n";
+    auto results = loader.LoadHistories(requested, startDate, endDate);
+    
+    std::vector<std::string> missing;
+    for (const auto& result : results) {
+        if (!result.error.empty() || result.data.empty()) {
+            missing.push_back(result.source);
+        }
+    }
+    if (!missing.empty()) {
+        auto localResults = loader.LoadBatchLocal(missing, workers);
+        size_t next = 0;
+        for (auto& result : results) {
+            if (!result.error.empty() || result.data.empty()) {
+                result = std::move(localResults[next++]);
+            }
+        }
+    }
+    
+    for (auto& result : results) {
+        if (result.error.empty()) {
+            std::cout << "  " << result.source << ": loaded " << result.data.size() << " points\n";
+            tickers.push_back(result.source);
+            stocksData.push_back(std::move(result.data));
+        } else {
+            std::cerr << "  Warning: Could not load " << result.source << "\n";
+        }
+    }
+}
+
 void CompareMultipleStocks(StockDataLoader& loader, DataProcessor& processor, Visualizer& visualizer) {
     int numStocks;
     std::cout << "\n--- Multiple Stock Comparison ---\n";
@@ -105,7 +181,7 @@ void CompareMultipleStocks(StockDataLoader& loader, DataProcessor& processor, Vi
     }
     
     std::vector<std::string> tickers;
-    std::vector<std::vector<StockData>> stocksData;
+    std::vector<PriceSeries> stocksData;
     std::string startDate, endDate;
     
     std::cout << "Enter start date (YYYY-MM-DD): ";
@@ -113,26 +189,16 @@ void CompareMultipleStocks(StockDataLoader& loader, DataProcessor& processor, Vi
     std::cout << "Enter end date (YYYY-MM-DD): ";
     std::cin >> endDate;
     
+    std::vector<std::string> requested;
     for (int i = 0; i < numStocks; ++i) {
         std::string ticker;
         std::cout << "Enter ticker #" << (i+1) << ": ";
         std::cin >> ticker;
-        tickers.push_back(ticker);
-        
-        std::cout << "Fetching " << ticker << "...\n";
-        auto data = loader.LoadFromAPI(ticker, startDate, endDate);
-        if (data.empty()) {
-            data = loader.LoadFromCSV(ticker + ".csv");
-        }
-        
-        if (!data.empty()) {
-            stocksData.push_back(data);
-            std::cout << "  Loaded " << data.size() << " points\n";
-        } else {
-            std::cerr << "  Warning: Could not load " << ticker << "\n";
-        }
+        requested.push_back(ticker);
     }
     
+    LoadTickers(loader, requested, startDate, endDate, tickers, stocksData);
+    
     if (stocksData.size() < 2) {
         std::cerr << "Error: Need at least 2 stocks with valid data\n";
         return;
@@ -140,21 +206,8 @@ void CompareMultipleStocks(StockDataLoader& loader, DataProcessor& processor, Vi
     
     // Calculate correlations
     std::cout << "\n--- Correlation Matrix ---\n";
-    std::vector<std::vector<double>> returns;
-    for (const auto& stock : stocksData) {
-        returns.push_back(processor.CalculateReturns(stock));
-    }
-    
-    // Align returns to same length
-    size_t minSize = SIZE_MAX;
-    for (auto& ret : returns) {
-        minSize = std::min(minSize, ret.size());
-    }
-    for (auto& ret : returns) {
-        if (ret.size() > minSize) {
-            ret.erase(ret.begin(), ret.begin() + (ret.size() - minSize));
-        }
-    }
+    // Returns over the dates all the stocks share
+    auto returns = processor.CalculateAlignedReturns(stocksData, tickers);
     
     std::cout << std::fixed << std::setprecision(3);
     std::cout << "      ";
@@ -163,11 +216,11 @@ void CompareMultipleStocks(StockDataLoader& loader, DataProcessor& processor, Vi
     }
     std::cout << "\n";
     
-    for (size_t i = 0; i < returns.size(); ++i) {
+    auto correlations = processor.CalculateCorrelationMatrix(returns);
+    for (size_t i = 0; i < correlations.size(); ++i) {
         std::cout << std::setw(6) << tickers[i];
-        for (size_t j = 0; j < returns.size(); ++j) {
-            double corr = processor.CalculateCorrelation(returns[i], returns[j]);
-            std::cout << std::setw(8) << corr;
+        for (size_t j = 0; j < correlations.size(); ++j) {
+            std::cout << std::setw(8) << correlations[i][j];
         }
         std::cout << "\n";
     }
@@ -188,7 +241,7 @@ void PerformPCA(StockDataLoader& loader, DataProcessor& processor, Visualizer& v
     std::cin >> topN;
     
     std::vector<std::string> tickers;
-    std::vector<std::vector<StockData>> stocksData;
+    std::vector<PriceSeries> stocksData;
     std::string startDate, endDate;
     
     std::cout << "Enter start date (YYYY-MM-DD): ";
@@ -196,24 +249,16 @@ void PerformPCA(StockDataLoader& loader, DataProcessor& processor, Visualizer& v
     std::cout << "Enter end date (YYYY-MM-DD): ";
     std::cin >> endDate;
     
+    std::vector<std::string> requested;
     for (int i = 0; i < numStocks; ++i) {
         std::string ticker;
         std::cout << "Enter ticker #" << (i+1) << ": ";
         std::cin >> ticker;
-        tickers.push_back(ticker);
-        
-        std::cout << "Fetching " << ticker << "...\n";
-        auto data = loader.LoadFromAPI(ticker, startDate, endDate);
-        if (data.empty()) {
-            data = loader.LoadFromCSV(ticker + ".csv");
-        }
-        
-        if (!data.empty()) {
-            stocksData.push_back(data);
-            std::cout << "  Loaded " << data.size() << " points\n";
-        }
+        requested.push_back(ticker);
     }
     
+    LoadTickers(loader, requested, startDate, endDate, tickers, stocksData);
+    
     if (stocksData.size() < 2) {
         std::cerr << "Error: Need at least 2 stocks for PCA\n";
         return;
@@ -224,12 +269,18 @@ void PerformPCA(StockDataLoader& loader, DataProcessor& processor, Visualizer& v
     
     if (pcaResult.success) {
         std::cout << "\n--- PCA Results ---\n";
+        std::cout << "Principal Components:\n";
+        for (size_t k = 0; k < pcaResult.explainedVariance.size(); ++k) {
+            std::cout << "PC" << (k+1) << ": variance " << std::fixed << std::setprecision(6)
+                     << pcaResult.explainedVariance[k] << " (" << std::setprecision(2)
+                     << pcaResult.explainedVarianceRatio[k] * 100 << "% explained)\n";
+        }
         std::cout << "Top " << topN << " Influential Stocks:\n";
         for (size_t i = 0; i < pcaResult.influentialStocks.size(); ++i) {
             std::cout << (i+1) << ". " << pcaResult.influentialStocks[i];
-            if (i < pcaResult.explainedVariance.size()) {
-                std::cout << " (Variance: " << std::fixed << std::setprecision(6) 
-                         << pcaResult.explainedVariance[i] << ")";
+            if (i < pcaResult.influence.size()) {
+                std::cout << " (Influence: " << std::fixed << std::setprecision(6) 
+                         << pcaResult.influence[i] << ")";
             }
             std::cout << "\n";
         }
@@ -238,14 +289,14 @@ void PerformPCA(StockDataLoader& loader, DataProcessor& processor, Visualizer& v
     }
 }
 
-void LoadFromCSV(StockDataLoader& loader, DataProcessor& processor, Visualizer& visualizer) {
+void LoadFromCSV(StockDataLoader& loader, DataProcessor& /*processor*/, Visualizer& visualizer) {
     std::string filepath;
     std::cout << "\n--- Load from CSV ---\n";
     std::cout << "Enter CSV file path: ";
     std::cin >> filepath;
     
     std::cout << "Loading data from " << filepath << "...\n";
-    auto data = loader.LoadFromCSV(filepath);
+    auto data = loader.LoadSeriesFromCSV(filepath);
     
     if (data.empty()) {
         std::cerr << "Error: Could not load data from " << filepath << "\n";
@@ -267,8 +318,9 @@ void LoadFromCSV(StockDataLoader& loader, DataProcessor& processor, Visualizer&
     
     visualizer.PrintConsoleSummary(data, ticker);
     
-    auto sma20 = processor.CalculateSMA(data, 20);
-    auto volatility = processor.CalculateRollingVolatility(data, 20);
+    IndicatorGraph graph(data);
+    const auto& sma20 = graph.Get({IndicatorKey::SMA, 20});
+    const auto& volatility = graph.Get({IndicatorKey::Volatility, 20});
     
     visualizer.PlotPriceTrend(data, ticker);
     visualizer.GenerateHTMLReport(data, sma20, volatility, ticker);
@@ -276,7 +328,7 @@ void LoadFromCSV(StockDataLoader& loader, DataProcessor& processor, Visualizer&
     std::cout << "Analysis complete!\n";
 }
 
-void GenerateAllReports(StockDataLoader& loader, DataProcessor& processor, Visualizer& visualizer) {
+void GenerateAllReports(StockDataLoader& loader, DataProcessor& /*processor*/, Visualizer& visualizer) {
     std::string ticker;
     std::string startDate, endDate;
     
@@ -289,9 +341,9 @@ void GenerateAllReports(StockDataLoader& loader, DataProcessor& processor, Visua
     std::cin >> endDate;
     
     std::cout << "\nFetching data...\n";
-    auto data = loader.LoadFromAPI(ticker, startDate, endDate);
+    auto data = loader.LoadSeriesFromAPI(ticker, startDate, endDate);
     if (data.empty()) {
-        data = loader.LoadFromCSV(ticker + ".csv");
+        data = loader.LoadLocalSeries(ticker);
     }
     
     if (data.empty()) {
@@ -300,22 +352,24 @@ void GenerateAllReports(StockDataLoader& loader, DataProcessor& processor, Visua
     }
     
     std::cout << "Calculating all indicators...\n";
-    auto sma20 = processor.CalculateSMA(data, 20);
-    auto sma50 = processor.CalculateSMA(data, 50);
-    auto ema20 = processor.CalculateEMA(data, 20);
-    auto volatility = processor.CalculateRollingVolatility(data, 20);
-    auto rsi = processor.CalculateRSI(data, 14);
-    auto macd = processor.CalculateMACD(data);
-    auto bollinger = processor.CalculateBollingerBands(data, 20, 2.0);
+    DataProcessor::IndicatorSet indicators = ReportIndicators();
+    IndicatorGraph graph(data);
+    graph.Prefetch(indicators);
+    const auto& sma = graph.Get({IndicatorKey::SMA, indicators.smaPeriods.front()});
+    const auto& ema = graph.Get({IndicatorKey::EMA, indicators.emaPeriods.front()});
+    const auto& volatility = graph.Get({IndicatorKey::Volatility, indicators.volatilityWindow});
+    const auto& rsi = graph.Get({IndicatorKey::RSI, indicators.rsiPeriod});
+    const auto& macd = graph.MACD(indicators.macdFast, indicators.macdSlow, indicators.macdSignal);
+    const auto& bollinger = graph.Bollinger(indicators.bollingerPeriod, indicators.bollingerStd);
     
     std::cout << "Generating all visualizations...\n";
     visualizer.PlotPriceTrend(data, ticker);
-    visualizer.PlotWithMovingAverages(data, sma20, ema20, ticker);
+    visualizer.PlotWithMovingAverages(data, sma, ema, ticker);
     visualizer.PlotVolatility(data, volatility, ticker);
     visualizer.PlotRSI(data, rsi, ticker);
     visualizer.PlotMACD(data, macd, ticker);
     visualizer.PlotBollingerBands(data, bollinger, ticker);
-    visualizer.GenerateHTMLReport(data, sma20, volatility, ticker);
+    visualizer.GenerateHTMLReport(data, sma, volatility, ticker);
     
     visualizer.PrintConsoleSummary(data, ticker);
     
@@ -323,7 +377,25 @@ void GenerateAllReports(StockDataLoader& loader, DataProcessor& processor, Visua
 }
 
 int main() {
+    const Config& config = Config::GetInstance();
     StockDataLoader loader;
+    loader.SetBaseURL(config.GetAPIBaseURL());
+    loader.SetFetchLimits(config.GetMaxInFlight(), config.GetMaxPerHost());
+    if (config.GetHistorySource() == "chart") {
+        loader.SetHistorySource(StockDataLoader::ChartAPI);
+    }
+    if (config.GetHttpMode() == "record" || config.GetHttpMode() == "replay") {
+        auto fixtures = std::make_shared<HttpFixtures>(
+            config.GetHttpMode() == "record" ? HttpFixtures::Record : HttpFixtures::Replay,
+            config.GetFixtureDirectory());
+        fixtures->SetLatency(std::chrono::milliseconds(config.GetReplayLatencyMs()));
+        fixtures->SetBandwidth(static_cast<size_t>(config.GetReplayBandwidthKBps()) * 1024);
+        loader.SetFixtures(fixtures);
+        std::cout << "HTTP " << config.GetHttpMode() << " mode using " << config.GetFixtureDirectory() << "\n";
+    }
+    if (!config.GetHistoryCacheDirectory().empty()) {
+        loader.SetHistoryCache(std::make_shared<HistoryCache>(loader, config.GetHistoryCacheDirectory()));
+    }
     DataProcessor processor;
     Visualizer visualizer("output");
     
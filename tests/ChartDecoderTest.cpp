@@ -0,0 +1,189 @@
+// ChartDecoder must return the bars and meta fields written into a chart
+// payload exactly (numbers as std::strtod reads them, dates as the exchange
+// day), whatever the layout and key order, and must fail cleanly on API
+// errors and malformed JSON.
+#include "ChartDecoder.h"
+#include "DateUtil.h"
+#include "JsonReader.h"
+#include "TestUtil.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace TestUtil;
+
+struct Bar {
+    int64_t timestamp;
+    std::string open, high, low, close, volume;  // as written; "null" for a gap
+};
+
+static const int64_t GmtOffset = -18000;  // New York, winter
+
+static std::vector<Bar> MakeBars(std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> price(10.0, 900.0);
+    std::uniform_int_distribution<int> gapOneIn(0, 9);
+    std::vector<Bar> bars;
+    int64_t open = 1704205800;  // 2024-01-02 09:30 EST
+    for (int i = 0; i < 400; ++i, open += 86400) {
+        char text[4][32];
+        for (auto& field : text) {
+            std::snprintf(field, sizeof(field), "%.17g", price(rng));
+        }
+        Bar bar{open, text[0], text[1], text[2], text[3], std::to_string(1000 + i * 37)};
+        if (gapOneIn(rng) == 0) {
+            bar.close = "null";
+        }
+        bars.push_back(bar);
+    }
+    return bars;
+}
+
+static std::string JsonArray(const std::vector<Bar>& bars, std::string Bar::*field, const char* space) {
+    std::string text = "[";
+    for (size_t i = 0; i < bars.size(); ++i) {
+        text += (i ? std::string(",") + space : std::string()) + bars[i].*field;
+    }
+    return text + "]";
+}
+
+// `pretty` spreads the payload over lines and moves the quote block
+// ahead of the timestamps, as a differently ordered server would
+static std::string Payload(const std::vector<Bar>& bars, bool pretty) {
+    const char* space = pretty ? "\n  " : "";
+    std::string timestamps = "[";
+    for (size_t i = 0; i < bars.size(); ++i) {
+        timestamps += (i ? std::string(",") + space : std::string()) + std::to_string(bars[i].timestamp);
+    }
+    timestamps += "]";
+
+    std::string meta = std::string("{\"currency\":\"USD\",") + space +
+                       "\"symbol\":\"BRK\\u002dB\",\"regularMarketPrice\":412.5,\"gmtoffset\":" +
+                       std::to_string(GmtOffset) + "," + space +
+                       "\"currentTradingPeriod\":{\"pre\":{\"start\":1,\"end\":2}}," +
+                       "\"validRanges\":[\"1d\",\"5d\"],\"chartPreviousClose\":1e2}";
+    std::string quote = std::string("{\"quote\":[{") + space +
+                        "\"volume\":" + JsonArray(bars, &Bar::volume, space) + "," + space +
+                        "\"close\":" + JsonArray(bars, &Bar::close, space) + "," + space +
+                        "\"low\":" + JsonArray(bars, &Bar::low, space) + "," + space +
+                        "\"open\":" + JsonArray(bars, &Bar::open, space) + "," + space +
+                        "\"high\":" + JsonArray(bars, &Bar::high, space) + "}]," +
+                        "\"adjclose\":[{\"adjclose\":[1,2,3]}]}";
+    std::string result = pretty ? "{\"meta\":" + meta + ",\n\"indicators\":" + quote +
+                                      ",\n\"timestamp\":" + timestamps + "}"
+                                : "{\"meta\":" + meta + ",\"timestamp\":" + timestamps +
+                                      ",\"indicators\":" + quote + "}";
+    return std::string("{\"chart\":{\"result\":[") + result + "],\"error\":null}}";
+}
+
+static void CheckDocument(const std::vector<Bar>& bars, bool pretty) {
+    std::string label = pretty ? "pretty payload" : "compact payload";
+    ChartDocument document;
+    bool ok = ChartDecoder::Decode(Payload(bars, pretty), document);
+    Expect(ok, label + ": " + document.error);
+    Expect(document.meta.symbol == "BRK-B", label + ": symbol");
+    Expect(document.meta.regularMarketPrice == 412.5 && document.meta.chartPreviousClose == 100.0 &&
+               document.meta.gmtOffset == GmtOffset && std::isnan(document.meta.previousClose),
+           label + ": meta numbers");
+
+    size_t row = 0;
+    for (const Bar& bar : bars) {
+        if (bar.close == "null") {
+            continue;
+        }
+        if (row >= document.bars.size()) {
+            Expect(false, label + ": too few bars");
+            return;
+        }
+        bool same =
+            document.bars.date[row] == DateUtil::UnixSecondsToDays(bar.timestamp + GmtOffset) &&
+            SameBits(document.bars.open[row], std::strtod(bar.open.c_str(), nullptr)) &&
+            SameBits(document.bars.high[row], std::strtod(bar.high.c_str(), nullptr)) &&
+            SameBits(document.bars.low[row], std::strtod(bar.low.c_str(), nullptr)) &&
+            SameBits(document.bars.close[row], std::strtod(bar.close.c_str(), nullptr)) &&
+            SameBits(document.bars.volume[row], std::strtod(bar.volume.c_str(), nullptr));
+        Expect(same, label + ": bar " + std::to_string(row));
+        ++row;
+    }
+    Expect(row == document.bars.size(), label + ": bar count");
+}
+
+static void CheckFailures() {
+    ChartDocument notFound;
+    bool ok = ChartDecoder::Decode(
+        "{\"chart\":{\"result\":null,\"error\":{\"code\":\"Not Found\","
+        "\"description\":\"No data found, symbol may be delisted\"}}}",
+        notFound);
+    Expect(!ok && notFound.error == "No data found, symbol may be delisted", "API error document");
+
+    for (const char* malformed : {"", "{", "{\"chart\":{\"result\":[{]}}", "{\"chart\":{\"result\":[]}}",
+                                  "{\"chart\":{\"result\":[{\"timestamp\":[1,]}]}}", "[1,2] trailing"}) {
+        ChartDocument document;
+        Expect(!ChartDecoder::Decode(malformed, document) && !document.error.empty() &&
+                   document.bars.empty(),
+               std::string("malformed payload '") + malformed + "'");
+    }
+}
+
+struct NumberCollector : JsonHandler {
+    std::vector<double> numbers;
+    void Number(double value) override { numbers.push_back(value); }
+};
+
+// Numbers beyond a double's range saturate as strtod does instead of
+// failing the document
+static void CheckNumbers() {
+    const char* texts[] = {"0", "-0", "1.5", "1e308", "1.7976931348623157e308", "4.9e-324",
+                           "1e400", "-1e400", "123456789012345678901234567890e300", "1E+999999999999",
+                           "1e-400", "-1e-400", "0.00000000001e-320", "1000000e-10000"};
+    std::string document = "[";
+    for (const char* text : texts) {
+        document += std::string(document.size() > 1 ? "," : "") + text;
+    }
+    document += "]";
+
+    NumberCollector collector;
+    JsonReader reader;
+    bool ok = reader.Parse(document, collector);
+    Expect(ok && collector.numbers.size() == sizeof(texts) / sizeof(texts[0]), "numbers: " + reader.Error());
+    for (size_t i = 0; ok && i < collector.numbers.size(); ++i) {
+        Expect(SameBits(collector.numbers[i], std::strtod(texts[i], nullptr)),
+               std::string("number ") + texts[i] + " read as " + Format(collector.numbers[i]));
+    }
+}
+
+static void CheckQuotes() {
+    std::vector<ChartMeta> quotes;
+    std::string error;
+    bool ok = ChartDecoder::DecodeQuotes(
+        "{\"quoteResponse\":{\"result\":["
+        "{\"symbol\":\"AAPL\",\"regularMarketPrice\":185.64,\"regularMarketPreviousClose\":181.91,"
+        "\"regularMarketVolume\":62303300,\"regularMarketTime\":1704488400},"
+        "{\"symbol\":\"MSFT\",\"regularMarketPrice\":367.75}],\"error\":null}}",
+        quotes, error);
+    Expect(ok && quotes.size() == 2, "quote batch: " + error);
+    if (quotes.size() == 2) {
+        Expect(quotes[0].symbol == "AAPL" && quotes[0].regularMarketPrice == 185.64 &&
+                   quotes[0].previousClose == 181.91 && quotes[0].regularMarketVolume == 62303300 &&
+                   quotes[0].regularMarketTime == 1704488400,
+               "quote batch: AAPL fields");
+        Expect(quotes[1].symbol == "MSFT" && quotes[1].regularMarketPrice == 367.75 &&
+                   std::isnan(quotes[1].previousClose),
+               "quote batch: MSFT fields");
+    }
+}
+
+int main() {
+    std::mt19937_64 rng(3);
+    std::vector<Bar> bars = MakeBars(rng);
+    CheckDocument(bars, false);
+    CheckDocument(bars, true);
+    CheckFailures();
+    CheckNumbers();
+    CheckQuotes();
+
+    return Finish("chart decoding matches the payload");
+}
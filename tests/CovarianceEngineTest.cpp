@@ -0,0 +1,83 @@
+// CovarianceEngine must reproduce DataProcessor::CalculateCorrelation and
+// the pairwise sample covariance bit for bit. The series are long enough
+// that TileRows gives blocks of a few rows, so the matrix is split into
+// many tiles, and the result must not depend on the worker count.
+#include "CovarianceEngine.h"
+#include "DataProcessor.h"
+#include "SimdKernels.h"
+#include "TestUtil.h"
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace TestUtil;
+
+static const size_t Stocks = 37;
+static const size_t Length = 4999;
+
+int main() {
+    std::mt19937_64 rng(23);
+    std::normal_distribution<double> normal;
+    std::vector<std::vector<double>> series(Stocks, std::vector<double>(Length));
+    for (size_t t = 0; t < Length; ++t) {
+        double market = 0.01 * normal(rng);
+        for (size_t i = 0; i < Stocks; ++i) {
+            series[i][t] = (0.5 + 0.02 * static_cast<double>(i)) * market + 0.01 * normal(rng);
+        }
+    }
+    // A flat price: zero returns correlate with nothing, themselves included
+    series[Stocks - 1].assign(Length, 0.0);
+
+    size_t block = CovarianceEngine::TileRows(Length);
+    Expect(block < Stocks / 2, "only " + std::to_string((Stocks + block - 1) / block) + " row blocks");
+
+    DataProcessor processor;
+    std::vector<double> means;
+    for (const auto& row : series) {
+        means.push_back(SimdKernels::Sum(row.data(), Length) / Length);
+    }
+
+    for (size_t workers : {1, 4}) {
+        std::string label = std::to_string(workers) + " worker(s)";
+        CovarianceEngine engine(workers);
+        auto matrices = engine.Compute(series);
+        Expect(matrices.success && matrices.covariance.size() == Stocks &&
+                   matrices.correlation.size() == Stocks,
+               label + ": no result");
+        if (!matrices.success) {
+            continue;
+        }
+
+        size_t correlationMismatches = 0;
+        size_t covarianceMismatches = 0;
+        for (size_t i = 0; i < Stocks; ++i) {
+            for (size_t j = 0; j < Stocks; ++j) {
+                double correlation = processor.CalculateCorrelation(series[i], series[j]);
+                double covariance = SimdKernels::SumCrossDeviations(series[i].data(), series[j].data(),
+                                                                    Length, means[i], means[j]) /
+                                    (Length - 1);
+                correlationMismatches += !SameBits(matrices.correlation[i][j], correlation);
+                covarianceMismatches += !SameBits(matrices.covariance[i][j], covariance);
+            }
+        }
+        Expect(correlationMismatches == 0,
+               label + ": " + std::to_string(correlationMismatches) + " correlations differ");
+        Expect(covarianceMismatches == 0,
+               label + ": " + std::to_string(covarianceMismatches) + " covariances differ");
+        Expect(matrices.correlation[Stocks - 1][Stocks - 1] == 0.0, label + ": constant series");
+
+        auto covarianceOnly = engine.Compute(series, false);
+        Expect(covarianceOnly.success && covarianceOnly.correlation.empty() &&
+                   covarianceOnly.covariance == matrices.covariance,
+               label + ": covariance without correlation");
+    }
+
+    CovarianceEngine engine(2);
+    using Rows = std::vector<std::vector<double>>;
+    Expect(!engine.Compute(Rows()).success, "empty panel accepted");
+    Expect(!engine.Compute(Rows{{1.0, 2.0}, {1.0}}).success, "ragged rows accepted");
+    Expect(!engine.Compute(Rows{{1.0}, {2.0}}).success, "single observation accepted");
+
+    return Finish("CovarianceEngine matches pairwise results (" + std::to_string(block) + "-row tiles)");
+}
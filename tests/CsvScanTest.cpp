@@ -0,0 +1,156 @@
+// The vectorized CSV path must agree with plain scalar code: FindStructural
+// with a byte-by-byte loop, ParseDouble with std::strtod, and CsvBarParser on
+// whole blocks (SIMD delimiter scan) with the same text fed a byte at a time
+// (every line goes through the scalar split of a pending line).
+#include "CsvBarParser.h"
+#include "CsvScan.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace TestUtil;
+
+static void CheckFindStructural(std::mt19937_64& rng) {
+    // Delimiters, ordinary text and bytes >= 0x80 (negative as signed char)
+    const char alphabet[] = {',', '\n', '\r', '"', '0', '9', '.', 'A', ' ', '\x80', '\xff', '\x2b'};
+    std::uniform_int_distribution<size_t> pick(0, sizeof(alphabet) - 1);
+
+    std::vector<char> buffer(512 + 64);
+    std::vector<uint32_t> positions(buffer.size());
+    for (size_t length = 0; length <= 512; ++length) {
+        // Every alignment of the start within a vector register
+        size_t offset = length % 64;
+        char* data = buffer.data() + offset;
+        for (size_t i = 0; i < length; ++i) {
+            data[i] = alphabet[pick(rng)];
+        }
+
+        std::vector<uint32_t> expected;
+        for (size_t i = 0; i < length; ++i) {
+            if (data[i] == ',' || data[i] == '\n') {
+                expected.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        size_t count = CsvScan::FindStructural(data, length, positions.data());
+        Expect(count == expected.size() &&
+                   std::equal(expected.begin(), expected.end(), positions.begin()),
+               "FindStructural (" + std::string(CsvScan::ActiveImplementation()) + ") length " +
+                   std::to_string(length));
+    }
+}
+
+static void CheckParseDouble(std::mt19937_64& rng) {
+    std::vector<std::string> inputs = {
+        "0", "-0", "+1", "1.", ".5", "007.250", "123456.789", "0.000001", "1e5", "1E-5",
+        "2.5e+3", "-1.7976931348623157e308", "4.9e-324", "9007199254740993",
+        "12345678901234567890123", "0.1000000000000000055511151231257827", "1e22", "1e23",
+        "3.14abc", "1e", "1e+", "inf", "-Infinity"};
+    std::uniform_int_distribution<int> digits(1, 20);
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::uniform_int_distribution<int> exponent(-30, 30);
+    std::uniform_int_distribution<int> coin(0, 3);
+    for (int n = 0; n < 20000; ++n) {
+        std::string text = coin(rng) == 0 ? "-" : "";
+        int whole = digits(rng);
+        for (int i = 0; i < whole; ++i) text += static_cast<char>('0' + digit(rng));
+        if (coin(rng) != 0) {
+            text += '.';
+            int fraction = digits(rng);
+            for (int i = 0; i < fraction; ++i) text += static_cast<char>('0' + digit(rng));
+        }
+        if (coin(rng) == 0) {
+            text += 'e' + std::to_string(exponent(rng));
+        }
+        inputs.push_back(text);
+    }
+
+    for (const std::string& text : inputs) {
+        double value = 0.0;
+        bool ok = CsvScan::ParseDouble(text.data(), text.data() + text.size(), value);
+        char* end = nullptr;
+        double expected = std::strtod(text.c_str(), &end);
+        Expect(ok == (end != text.c_str()) && (!ok || SameBits(value, expected)),
+               "ParseDouble(\"" + text + "\")");
+    }
+}
+
+static PriceSeries ParseInChunks(const std::string& text, size_t chunk, size_t& accepted) {
+    PriceSeries series;
+    CsvBarParser parser(series);
+    for (size_t offset = 0; offset < text.size(); offset += chunk) {
+        parser.Feed(text.data() + offset, std::min(chunk, text.size() - offset));
+    }
+    parser.Finish();
+    accepted = parser.RowsAccepted();
+    return series;
+}
+
+static void CheckBarParser(std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> price(1.0, 5000.0);
+    std::uniform_int_distribution<int> kind(0, 19);
+    std::string text = "Date,Open,High,Low,Close,Adj Close,Volume\r\n";
+    std::vector<double> closes;
+    for (int row = 0; row < 3000; ++row) {
+        char line[256];
+        int year = 2000 + row / 300;
+        int month = 1 + (row / 25) % 12;
+        int day = 1 + row % 25;
+        double close = price(rng);
+        switch (kind(rng)) {
+        case 0:  // unparseable row, dropped
+            std::snprintf(line, sizeof(line), "%04d-%02d-%02d,null,null,null,null,null,null\n", year,
+                          month, day);
+            break;
+        case 1:  // quoted and padded fields, CRLF
+            std::snprintf(line, sizeof(line), "\"%04d-%02d-%02d\", %.4f ,%.4f,%.4f,\"%.6f\",%.6f,%d\r\n",
+                          year, month, day, close, close, close, close, close, row * 100);
+            closes.push_back(close);
+            break;
+        default:
+            std::snprintf(line, sizeof(line), "%04d-%02d-%02d,%.2f,%.2f,%.2f,%.6f,%.6f,%d\n", year, month,
+                          day, close, close + 1, close - 1, close, close, row * 1000);
+            closes.push_back(close);
+            break;
+        }
+        text += line;
+    }
+    text += "2030-01-01,1,2,0.5,1.5,1.5,100";  // no trailing newline
+
+    size_t wholeAccepted = 0;
+    PriceSeries whole = ParseInChunks(text, text.size(), wholeAccepted);
+    Expect(wholeAccepted == closes.size() + 1, "CsvBarParser accepted rows");
+    for (size_t i = 0; i < closes.size() && i < whole.size(); ++i) {
+        char formatted[64];
+        std::snprintf(formatted, sizeof(formatted), "%.6f", closes[i]);
+        if (!SameBits(whole.close[i], std::strtod(formatted, nullptr))) {
+            Expect(false, "CsvBarParser close of row " + std::to_string(i));
+        }
+    }
+
+    for (size_t chunk : {size_t(1), size_t(7), size_t(4096)}) {
+        size_t accepted = 0;
+        PriceSeries split = ParseInChunks(text, chunk, accepted);
+        bool same = accepted == wholeAccepted && split.size() == whole.size();
+        for (size_t i = 0; same && i < whole.size(); ++i) {
+            same = split.date[i] == whole.date[i] && SameBits(split.open[i], whole.open[i]) &&
+                   SameBits(split.high[i], whole.high[i]) && SameBits(split.low[i], whole.low[i]) &&
+                   SameBits(split.close[i], whole.close[i]) &&
+                   SameBits(split.volume[i], whole.volume[i]);
+        }
+        Expect(same, "CsvBarParser in " + std::to_string(chunk) + "-byte chunks");
+    }
+}
+
+int main() {
+    std::mt19937_64 rng(11);
+    CheckFindStructural(rng);
+    CheckParseDouble(rng);
+    CheckBarParser(rng);
+
+    return Finish("CSV scanning (" + std::string(CsvScan::ActiveImplementation()) + ") matches scalar parsing");
+}
@@ -0,0 +1,151 @@
+// HistoryCache gap bookkeeping: which parts of a request are missing, that
+// a fetched gap is recorded even when it held no bars, that a failed one is
+// left open, and that days from today onward are never recorded. Fetches
+// are replayed from fixtures written here, so nothing touches the network.
+#include "DateUtil.h"
+#include "HistoryCache.h"
+#include "HttpFixtures.h"
+#include "TestUtil.h"
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+using namespace TestUtil;
+
+static std::string Describe(const std::vector<DateRange>& ranges) {
+    std::string text;
+    for (const DateRange& range : ranges) {
+        text += "[" + std::to_string(range.begin) + ", " + std::to_string(range.end) + ")";
+    }
+    return text.empty() ? "none" : text;
+}
+
+static void CheckMissingRanges() {
+    struct Case {
+        const char* name;
+        std::vector<DateRange> stored;
+        DateRange wanted;
+        std::vector<DateRange> missing;
+    };
+    const std::vector<Case> cases = {
+        {"nothing stored", {}, {10, 20}, {{10, 20}}},
+        {"fully covered", {{5, 25}}, {10, 20}, {}},
+        {"exactly covered", {{10, 20}}, {10, 20}, {}},
+        {"stored ends where wanted begins", {{0, 10}}, {10, 20}, {{10, 20}}},
+        {"stored begins where wanted ends", {{20, 30}}, {10, 20}, {{10, 20}}},
+        {"head covered", {{0, 15}}, {10, 20}, {{15, 20}}},
+        {"tail covered", {{15, 30}}, {10, 20}, {{10, 15}}},
+        {"hole in the middle", {{0, 12}, {14, 30}}, {10, 20}, {{12, 14}}},
+        {"several holes", {{11, 12}, {13, 14}, {18, 19}}, {10, 20}, {{10, 11}, {12, 13}, {14, 18}, {19, 20}}},
+        {"one-day hole", {{0, 15}, {16, 30}}, {10, 20}, {{15, 16}}},
+        {"one-day request", {{0, 10}, {11, 30}}, {10, 11}, {{10, 11}}},
+    };
+    for (const Case& test : cases) {
+        auto missing = HistoryCache::MissingRanges(test.stored, test.wanted);
+        bool same = missing.size() == test.missing.size();
+        for (size_t i = 0; same && i < missing.size(); ++i) {
+            same = missing[i].begin == test.missing[i].begin && missing[i].end == test.missing[i].end;
+        }
+        Expect(same, std::string("MissingRanges, ") + test.name + ": got " + Describe(missing));
+    }
+}
+
+static int32_t Day(const char* text) {
+    int32_t days = 0;
+    DateUtil::ParseDate(text, days);
+    return days;
+}
+
+// Writes the response a CSV history request for [begin, end) replays
+static void AddFixture(const HttpFixtures& fixtures, const std::string& ticker, int32_t begin,
+                       int32_t end, const std::vector<const char*>& barDates) {
+    std::string url = "/v7/finance/download/" + ticker +
+                      "?period1=" + std::to_string(DateUtil::DaysToUnixSeconds(begin)) +
+                      "&period2=" + std::to_string(DateUtil::DaysToUnixSeconds(end)) +
+                      "&interval=1d&events=history";
+    std::string body = "Date,Open,High,Low,Close,Adj Close,Volume\n";
+    for (const char* date : barDates) {
+        body += std::string(date) + ",10,11,9,10.5,10.5,1000\n";
+    }
+    fixtures.Save(url, 200, body);
+}
+
+static bool SameRanges(const std::vector<DateRange>& actual, const std::vector<DateRange>& expected) {
+    return Describe(actual) == Describe(expected);
+}
+
+int main() {
+    CheckMissingRanges();
+
+    fs::path directory = fs::temp_directory_path() / "stocksense_history_cache_test";
+    fs::remove_all(directory);
+    auto fixtures = std::make_shared<HttpFixtures>(HttpFixtures::Replay, (directory / "fixtures").string());
+    fs::create_directories(fixtures->GetDirectory());
+
+    StockDataLoader loader;
+    loader.SetFixtures(fixtures);
+    HistoryCache cache(loader, (directory / "cache").string());
+
+    // Recorded ranges are merged where they overlap or touch, and a
+    // covered request fetches nothing
+    {
+        std::ofstream ranges(directory / "cache" / "ZZZ.ranges");
+        ranges << "# StockSense history ranges v1: [begin, end) per line\n"
+               << "2024-01-05 2024-01-10\n2024-01-20 2024-01-25\n"
+               << "2024-01-01 2024-01-05\n2024-01-08 2024-01-12\n";
+    }
+    Expect(SameRanges(cache.StoredRanges("ZZZ"),
+                      {{Day("2024-01-01"), Day("2024-01-12")}, {Day("2024-01-20"), Day("2024-01-25")}}),
+           "merged ranges: " + Describe(cache.StoredRanges("ZZZ")));
+    cache.Load("ZZZ", "2024-01-03", "2024-01-12");
+    Expect(cache.RangesFetched() == 0, "covered range fetched");
+
+    // A gap with bars is fetched once and then served from disk
+    AddFixture(*fixtures, "AAA", Day("2024-01-01"), Day("2024-01-10"),
+               {"2024-01-02", "2024-01-03", "2024-01-05"});
+    PriceSeries first = cache.Load("AAA", "2024-01-01", "2024-01-10");
+    Expect(first.size() == 3 && cache.RangesFetched() == 1 && cache.BarsFetched() == 3, "first load");
+    Expect(SameRanges(cache.StoredRanges("AAA"), {{Day("2024-01-01"), Day("2024-01-10")}}),
+           "first load ranges: " + Describe(cache.StoredRanges("AAA")));
+    PriceSeries again = cache.Load("AAA", "2024-01-02", "2024-01-04");
+    Expect(again.size() == 2 && cache.RangesFetched() == 1, "covered load fetched again");
+
+    // Widening fetches just the two new gaps; the first has no bars (a
+    // holiday week) and is recorded all the same, so the ranges merge
+    AddFixture(*fixtures, "AAA", Day("2023-12-25"), Day("2024-01-01"), {});
+    AddFixture(*fixtures, "AAA", Day("2024-01-10"), Day("2024-01-15"), {"2024-01-11", "2024-01-12"});
+    PriceSeries wider = cache.Load("AAA", "2023-12-25", "2024-01-15");
+    Expect(wider.size() == 5 && cache.RangesFetched() == 3 && cache.BarsFetched() == 5, "widened load");
+    Expect(SameRanges(cache.StoredRanges("AAA"), {{Day("2023-12-25"), Day("2024-01-15")}}),
+           "widened ranges: " + Describe(cache.StoredRanges("AAA")));
+    cache.Load("AAA", "2023-12-25", "2024-01-15");
+    Expect(cache.RangesFetched() == 3, "empty gap fetched again");
+
+    // A gap with no fixture fails and stays open
+    PriceSeries failed = cache.Load("BBB", "2024-01-01", "2024-01-10");
+    Expect(failed.empty() && cache.StoredRanges("BBB").empty(), "failed gap recorded");
+    auto retried = cache.LoadBatch({"BBB"}, "2024-01-01", "2024-01-10");
+    Expect(!retried[0].error.empty() && cache.RangesFetched() == 5, "failed gap not retried");
+
+    // Today and later are fetched but never recorded as covered
+    int32_t today = DateUtil::UnixSecondsToDays(static_cast<int64_t>(std::time(nullptr)));
+    AddFixture(*fixtures, "CCC", today - 3, today + 2, {});
+    AddFixture(*fixtures, "CCC", today, today + 2, {});
+    std::string from = DateUtil::FormatDate(today - 3);
+    std::string to = DateUtil::FormatDate(today + 2);
+    size_t before = cache.RangesFetched();
+    cache.Load("CCC", from, to);
+    Expect(SameRanges(cache.StoredRanges("CCC"), {{today - 3, today}}),
+           "ranges reaching today: " + Describe(cache.StoredRanges("CCC")));
+    cache.Load("CCC", from, to);
+    Expect(cache.RangesFetched() == before + 2, "today's gap not refetched");
+    Expect(SameRanges(cache.StoredRanges("CCC"), {{today - 3, today}}), "today recorded on refetch");
+
+    fs::remove_all(directory);
+    return Finish("HistoryCache fetches only what is missing");
+}
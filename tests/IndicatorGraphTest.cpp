@@ -0,0 +1,111 @@
+// IndicatorGraph must return exactly what the DataProcessor functions
+// return, whether an indicator is computed on demand or prefetched through
+// the fused pipeline, and must compute each indicator only once.
+#include "DataProcessor.h"
+#include "IndicatorGraph.h"
+#include "TestUtil.h"
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace TestUtil;
+
+static bool Same(const std::vector<double>& a, const std::vector<double>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!SameBits(a[i], b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void CheckAgainstProcessor(IndicatorGraph& graph, const PriceSeries& series,
+                                  const std::string& label) {
+    DataProcessor processor;
+    Expect(Same(graph.Get({IndicatorKey::Returns}), processor.CalculateReturns(series)),
+           label + ": returns");
+    Expect(Same(graph.Get({IndicatorKey::SMA, 20}), processor.CalculateSMA(series, 20)),
+           label + ": SMA(20)");
+    Expect(Same(graph.Get({IndicatorKey::SMA, 50}), processor.CalculateSMA(series, 50)),
+           label + ": SMA(50)");
+    Expect(Same(graph.Get({IndicatorKey::EMA, 12}), processor.CalculateEMA(series, 12)),
+           label + ": EMA(12)");
+    Expect(Same(graph.Get({IndicatorKey::Volatility, 20}), processor.CalculateVolatility(series, 20)),
+           label + ": volatility(20)");
+    Expect(Same(graph.Get({IndicatorKey::RSI, 14}), processor.CalculateRSI(series, 14)),
+           label + ": RSI(14)");
+
+    auto macd = processor.CalculateMACD(series, 12, 26, 9);
+    const auto& graphMACD = graph.MACD(12, 26, 9);
+    Expect(Same(graphMACD.macd, macd.macd) && Same(graphMACD.signal, macd.signal) &&
+               Same(graphMACD.histogram, macd.histogram),
+           label + ": MACD");
+    Expect(Same(graph.Get({IndicatorKey::MACDSignal, 12, 26, 9}), macd.signal),
+           label + ": MACD signal by key");
+
+    auto bands = processor.CalculateBollingerBands(series, 20, 2.0);
+    const auto& graphBands = graph.Bollinger(20, 2.0);
+    Expect(Same(graphBands.middle, bands.middle) && Same(graphBands.upper, bands.upper) &&
+               Same(graphBands.lower, bands.lower),
+           label + ": Bollinger");
+    Expect(Same(graph.Get({IndicatorKey::BollingerLower, 20, 0, 0, 2.0}), bands.lower),
+           label + ": Bollinger lower by key");
+}
+
+int main() {
+    std::mt19937_64 rng(20);
+    std::normal_distribution<double> logReturn(0.0, 0.02);
+    PriceSeries series;
+    double price = 100.0;
+    for (int i = 0; i < 500; ++i) {
+        price *= std::exp(logReturn(rng));
+        StockData bar{};
+        bar.date = i;
+        bar.close = price;
+        series.push_back(bar);
+    }
+
+    // On demand: SMA(20), SMA(50), EMA(12), returns, volatility, RSI, EMA(26)
+    // for the MACD, the MACD itself and the bands
+    IndicatorGraph lazy(series);
+    CheckAgainstProcessor(lazy, series, "on demand");
+    Expect(lazy.Evaluations() == 9, "on demand: " + std::to_string(lazy.Evaluations()) +
+                                        " evaluations, expected 9");
+    CheckAgainstProcessor(lazy, series, "cached");
+    Expect(lazy.Evaluations() == 9, "cached lookups evaluated again");
+
+    // The same indicators prefetched in one pipeline pass; the Bollinger
+    // middle band stands in for SMA(20), so nothing is left for Get
+    IndicatorGraph prefetched(series);
+    DataProcessor::IndicatorSet set;
+    set.smaPeriods = {20, 50};
+    set.emaPeriods = {12};
+    set.returns = true;
+    set.volatilityWindow = 20;
+    set.rsiPeriod = 14;
+    set.macd = true;
+    set.bollingerPeriod = 20;
+    prefetched.Prefetch(set);
+    size_t afterPrefetch = prefetched.Evaluations();
+    CheckAgainstProcessor(prefetched, series, "prefetched");
+    Expect(afterPrefetch == 8 && prefetched.Evaluations() == 8,
+           "prefetched: " + std::to_string(prefetched.Evaluations()) + " evaluations, expected 8");
+
+    // Bollinger after SMA of the same period reuses the SMA
+    IndicatorGraph shared(series);
+    shared.Get({IndicatorKey::SMA, 20});
+    shared.Bollinger(20, 2.0);
+    Expect(shared.Evaluations() == 2, "Bollinger(20) recomputed SMA(20)");
+    shared.Bollinger(20, 3.0);
+    Expect(shared.Evaluations() == 3, "second Bollinger width recomputed SMA(20)");
+
+    shared.Clear();
+    shared.Get({IndicatorKey::SMA, 20});
+    Expect(shared.Evaluations() == 4, "Clear kept a cached result");
+
+    return Finish("IndicatorGraph matches DataProcessor");
+}
@@ -0,0 +1,87 @@
+// The rolling-sum SMA and the prefix-sum CalculateSMAs must stay within
+// rounding distance of the plain per-window mean, computed here in long
+// double, on a long series of prices near 1e6 (where an uncompensated
+// running sum would drift).
+#include "DataProcessor.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace TestUtil;
+
+static const size_t Bars = 50000;
+
+// Worst error of `sma` against the naive mean of each window, relative to
+// the mean; windows are checked every `stride` outputs
+static double WorstError(const std::vector<double>& closes, const std::vector<double>& sma,
+                         size_t period, size_t stride) {
+    double worst = 0.0;
+    for (size_t k = 0; k < sma.size(); k += stride) {
+        long double sum = 0.0L;
+        for (size_t i = k; i < k + period; ++i) {
+            sum += closes[i];
+        }
+        long double mean = sum / static_cast<long double>(period);
+        worst = std::max(worst, static_cast<double>(std::fabs((sma[k] - mean) / mean)));
+    }
+    return worst;
+}
+
+int main() {
+    std::mt19937_64 rng(17);
+    std::normal_distribution<double> move(0.0, 25.0);
+    std::vector<double> closes;
+    PriceSeries series;
+    double price = 1e6;
+    for (size_t i = 0; i < Bars; ++i) {
+        price += move(rng);
+        closes.push_back(price);
+        StockData bar{};
+        bar.date = static_cast<int32_t>(i);
+        bar.close = price;
+        series.push_back(bar);
+    }
+
+    DataProcessor processor;
+    std::vector<int> periods = {1, 2, 20, 50, 200, 1000};
+    auto compensated = processor.CalculateSMAs(series, periods, true);
+    auto plain = processor.CalculateSMAs(series, periods, false);
+
+    for (size_t p = 0; p < periods.size(); ++p) {
+        size_t period = static_cast<size_t>(periods[p]);
+        size_t stride = period > 200 ? 97 : 1;
+        std::string label = "SMA(" + std::to_string(period) + ")";
+        auto rolling = processor.CalculateSMA(series, periods[p]);
+
+        Expect(rolling.size() == Bars - period + 1, label + " length");
+        Expect(compensated[p].size() == rolling.size() && plain[p].size() == rolling.size(),
+               label + " CalculateSMAs length");
+        if (rolling.size() != Bars - period + 1 || compensated[p].size() != rolling.size() ||
+            plain[p].size() != rolling.size()) {
+            continue;
+        }
+
+        // One or two ulps of the mean; the reference agrees to ~1e-16
+        double rollingError = WorstError(closes, rolling, period, stride);
+        double compensatedError = WorstError(closes, compensated[p], period, stride);
+        Expect(rollingError < 1e-14, label + " rolling error " + Format(rollingError));
+        Expect(compensatedError < 1e-14,
+               label + " compensated prefix error " + Format(compensatedError));
+
+        // Without compensation the prefix sums reach 5e10 and lose about
+        // four digits (~4e-12 here), still far below a cent
+        double plainError = WorstError(closes, plain[p], period, stride);
+        Expect(plainError < 1e-10, label + " plain prefix error " + Format(plainError));
+    }
+
+    // Periods the series is too short for give empty output
+    Expect(processor.CalculateSMA(series, static_cast<int>(Bars) + 1).empty(), "SMA longer than series");
+    Expect(processor.CalculateSMA(series, 0).empty(), "SMA(0)");
+    Expect(processor.CalculateSMAs(series, {0, static_cast<int>(Bars) + 1})[1].empty(),
+           "CalculateSMAs longer than series");
+
+    return Finish("SMAs match per-window sums");
+}
@@ -0,0 +1,95 @@
+// PanelBuilder on small hand-built series: each case lists the series, the
+// join policy and the panel expected back, with NaN for a cell that must
+// be invalid.
+#include "PanelBuilder.h"
+#include "TestUtil.h"
+#include <cmath>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace TestUtil;
+
+static const double None = std::numeric_limits<double>::quiet_NaN();
+
+using Bars = std::vector<std::pair<int32_t, double>>;  // date, close
+
+struct Case {
+    const char* name;
+    JoinPolicy policy;
+    std::vector<Bars> series;
+    bool fails;
+    std::vector<int32_t> dates;
+    std::vector<std::vector<double>> cells;  // [ticker][date]
+};
+
+static const Bars A = {{1, 10}, {2, 11}, {4, 13}};
+static const Bars B = {{2, 20}, {3, 21}, {4, 22}};
+
+static const std::vector<Case> Cases = {
+    {"inner", JoinPolicy::Inner, {A, B}, false, {2, 4}, {{11, 13}, {20, 22}}},
+    {"outer", JoinPolicy::Outer, {A, B}, false, {1, 2, 3, 4}, {{10, 11, None, 13}, {None, 20, 21, 22}}},
+    {"forward fill", JoinPolicy::ForwardFill, {A, B}, false, {1, 2, 3, 4},
+     {{10, 11, 11, 13}, {None, 20, 21, 22}}},
+    {"single series", JoinPolicy::Inner, {A}, false, {1, 2, 4}, {{10, 11, 13}}},
+    {"repeated date, inner", JoinPolicy::Inner, {{{1, 10}, {2, 11}, {2, 12}, {3, 13}}, {{1, 20}, {2, 21}, {3, 22}}},
+     false, {1, 2, 3}, {{10, 12, 13}, {20, 21, 22}}},
+    {"repeated date, forward fill", JoinPolicy::ForwardFill,
+     {{{1, 10}, {3, 11}, {3, 12}}, {{1, 20}, {2, 21}, {3, 22}, {4, 23}}}, false, {1, 2, 3, 4},
+     {{10, 10, 12, 12}, {20, 21, 22, 23}}},
+    {"out of order", JoinPolicy::Outer, {A, {{1, 20}, {3, 21}, {2, 22}}}, true, {}, {}},
+    {"empty series, inner", JoinPolicy::Inner, {A, {}}, false, {}, {{}, {}}},
+    {"empty series, outer", JoinPolicy::Outer, {A, {}}, false, {1, 2, 4}, {{10, 11, 13}, {None, None, None}}},
+    {"empty series, forward fill", JoinPolicy::ForwardFill, {{}, A}, false, {1, 2, 4},
+     {{None, None, None}, {10, 11, 13}}},
+    {"all empty", JoinPolicy::Outer, {{}, {}}, false, {}, {{}, {}}},
+};
+
+static void Check(const Case& test) {
+    std::vector<PriceSeries> series(test.series.size());
+    PanelBuilder builder(test.policy);
+    for (size_t s = 0; s < test.series.size(); ++s) {
+        for (const auto& bar : test.series[s]) {
+            StockData data{};
+            data.date = bar.first;
+            data.close = bar.second;
+            data.open = bar.second - 1.0;
+            series[s].push_back(data);
+        }
+        builder.Add(series[s], "T" + std::to_string(s));
+    }
+
+    std::string name = test.name;
+    Panel panel = builder.Build();
+    if (test.fails) {
+        Expect(panel.Tickers() == 0, name + ": built a panel");
+        return;
+    }
+    Expect(panel.Tickers() == test.series.size(), name + ": ticker count");
+    Expect(panel.DateAxis() == test.dates, name + ": date axis");
+    if (panel.Tickers() != test.series.size() || panel.DateAxis() != test.dates) {
+        return;
+    }
+
+    Panel opens = builder.Build(&PriceSeries::open);
+    for (size_t t = 0; t < panel.Tickers(); ++t) {
+        for (size_t d = 0; d < panel.Dates(); ++d) {
+            std::string cell = name + ": ticker " + std::to_string(t) + " date " + std::to_string(d);
+            double expected = test.cells[t][d];
+            if (std::isnan(expected)) {
+                Expect(!panel.IsValid(d, t) && std::isnan(panel.Value(d, t)), cell + " should be invalid");
+                continue;
+            }
+            Expect(panel.IsValid(d, t) && panel.Value(d, t) == expected, cell);
+            Expect(opens.IsValid(d, t) && opens.Value(d, t) == expected - 1.0, cell + " (opens)");
+        }
+    }
+}
+
+int main() {
+    for (const Case& test : Cases) {
+        Check(test);
+    }
+    return Finish("PanelBuilder joins " + std::to_string(Cases.size()) + " cases as expected");
+}
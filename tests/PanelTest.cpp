@@ -0,0 +1,101 @@
+// Panel::WithLayout must round-trip every value and validity bit, for
+// shapes that are not multiples of the 32 x 32 transpose tile and whose
+// leading dimension is padded, and every column or row must start on a
+// 64-byte boundary.
+#include "Panel.h"
+#include "TestUtil.h"
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace TestUtil;
+
+static bool Aligned(const double* p) {
+    return reinterpret_cast<uintptr_t>(p) % Panel::Alignment == 0;
+}
+
+static bool SameCells(const Panel& a, const Panel& b) {
+    if (a.Tickers() != b.Tickers() || a.Dates() != b.Dates() || a.ValidCount() != b.ValidCount()) {
+        return false;
+    }
+    for (size_t t = 0; t < a.Tickers(); ++t) {
+        for (size_t d = 0; d < a.Dates(); ++d) {
+            if (a.IsValid(d, t) != b.IsValid(d, t) || !SameBits(a.Value(d, t), b.Value(d, t))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void Check(size_t tickers, size_t dates) {
+    std::string label = std::to_string(dates) + " dates x " + std::to_string(tickers) + " tickers";
+    std::vector<std::string> names;
+    for (size_t t = 0; t < tickers; ++t) {
+        names.push_back("T" + std::to_string(t));
+    }
+    std::vector<int32_t> axis;
+    for (size_t d = 0; d < dates; ++d) {
+        axis.push_back(static_cast<int32_t>(d));
+    }
+
+    // Every third cell stays invalid
+    Panel panel(names, axis);
+    size_t valid = 0;
+    for (size_t t = 0; t < tickers; ++t) {
+        for (size_t d = 0; d < dates; ++d) {
+            if ((t * 7 + d) % 3 != 0) {
+                panel.Set(d, t, static_cast<double>(t) * 1000.0 + static_cast<double>(d) + 0.25);
+                ++valid;
+            }
+        }
+    }
+    Expect(panel.ValidCount() == valid, label + ": valid count");
+
+    Panel rows = panel.WithLayout(Panel::Layout::RowMajor);
+    Panel back = rows.WithLayout(Panel::Layout::ColumnMajor);
+    Expect(rows.StorageLayout() == Panel::Layout::RowMajor &&
+               back.StorageLayout() == Panel::Layout::ColumnMajor,
+           label + ": layouts");
+    Expect(SameCells(panel, rows), label + ": row-major copy differs");
+    Expect(SameCells(panel, back), label + ": round trip differs");
+    Expect(rows.TickerNames() == names && rows.DateAxis() == axis, label + ": axes");
+
+    bool views = true;
+    bool aligned = true;
+    for (size_t t = 0; t < tickers; ++t) {
+        views = views && panel.Column(t).IsContiguous() && !rows.Column(t).IsContiguous();
+        aligned = aligned && Aligned(panel.Column(t).data());
+        for (size_t d = 0; d < dates; ++d) {
+            views = views && SameBits(rows.Column(t)[d], panel.Value(d, t));
+        }
+    }
+    for (size_t d = 0; d < dates; ++d) {
+        views = views && rows.Row(d).IsContiguous();
+        aligned = aligned && Aligned(rows.Row(d).data());
+        for (size_t t = 0; t < tickers; ++t) {
+            views = views && SameBits(panel.Row(d)[t], rows.Value(d, t));
+        }
+    }
+    Expect(views, label + ": column/row views");
+    Expect(aligned, label + ": a column or row is not 64-byte aligned");
+    if (tickers > 1 && dates > 0) {
+        // The column stride is the padded leading dimension
+        size_t leading = static_cast<size_t>(panel.Column(1).data() - panel.Column(0).data());
+        Expect(leading >= dates && leading % (Panel::Alignment / sizeof(double)) == 0 &&
+                   leading == panel.Row(0).stride(),
+               label + ": leading dimension " + std::to_string(leading));
+    }
+}
+
+int main() {
+    for (size_t tickers : {1, 3, 31, 33, 70}) {
+        for (size_t dates : {1, 7, 32, 45, 100}) {
+            Check(tickers, dates);
+        }
+    }
+    Check(0, 10);
+    Check(10, 0);
+    return Finish("Panel layouts round-trip");
+}
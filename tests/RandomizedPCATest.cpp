@@ -0,0 +1,86 @@
+// Randomized PCA must find the same top components as the exact
+// eigendecomposition. The panel follows a three-factor model with well
+// separated factor strengths, so the top three eigenvalues stand clear of
+// the noise and of each other.
+#include "DataProcessor.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace TestUtil;
+
+static const size_t Stocks = 80;
+static const size_t Dates = 400;
+static const int TopN = 3;
+
+int main() {
+    std::mt19937_64 rng(22);
+    std::normal_distribution<double> normal;
+    std::vector<std::vector<double>> exposures(Stocks, std::vector<double>(TopN));
+    for (auto& stock : exposures) {
+        for (double& exposure : stock) {
+            exposure = normal(rng);
+        }
+    }
+
+    std::vector<PriceSeries> stocks(Stocks);
+    std::vector<std::string> tickers;
+    std::vector<double> prices(Stocks, 100.0);
+    for (size_t s = 0; s < Stocks; ++s) {
+        tickers.push_back("S" + std::to_string(s));
+    }
+    const double factorScale[TopN] = {0.02, 0.01, 0.005};
+    for (size_t d = 0; d < Dates; ++d) {
+        double factors[TopN];
+        for (int f = 0; f < TopN; ++f) {
+            factors[f] = factorScale[f] * normal(rng);
+        }
+        for (size_t s = 0; s < Stocks; ++s) {
+            double r = 0.002 * normal(rng);
+            for (int f = 0; f < TopN; ++f) {
+                r += exposures[s][f] * factors[f];
+            }
+            prices[s] *= 1.0 + r;
+            StockData bar{};
+            bar.date = static_cast<int32_t>(d);
+            bar.close = prices[s];
+            stocks[s].push_back(bar);
+        }
+    }
+
+    // Well below RandomizedPCAMinStocks, so Auto would pick Exact
+    DataProcessor processor;
+    auto exact = processor.PerformPCA(stocks, tickers, TopN, DataProcessor::PCAMethod::Exact);
+    auto randomized = processor.PerformPCA(stocks, tickers, TopN, DataProcessor::PCAMethod::Randomized);
+    Expect(exact.success && randomized.success, "PCA failed");
+    if (!exact.success || !randomized.success) {
+        return Finish("");
+    }
+    Expect(exact.explainedVariance.size() == TopN && randomized.explainedVariance.size() == TopN &&
+               randomized.principalComponents.size() == TopN,
+           "component count");
+
+    for (size_t k = 0; k < TopN && k < randomized.explainedVariance.size(); ++k) {
+        std::string label = "component " + std::to_string(k);
+        double expected = exact.explainedVariance[k];
+        double error = std::fabs(randomized.explainedVariance[k] - expected) / expected;
+        Expect(error < 1e-9, label + " eigenvalue off by " + Format(error) + " (relative)");
+        Expect(std::fabs(randomized.explainedVarianceRatio[k] - exact.explainedVarianceRatio[k]) < 1e-6,
+               label + " explained variance ratio");
+
+        // Loadings are unit vectors, equal up to sign; the weakest factor's
+        // converge slowest (a few 1e-7 here)
+        double worst = 0.0;
+        for (size_t s = 0; s < Stocks; ++s) {
+            worst = std::max(worst, std::fabs(std::fabs(randomized.principalComponents[k][s]) -
+                                              std::fabs(exact.principalComponents[k][s])));
+        }
+        Expect(worst < 1e-5, label + " loadings off by " + Format(worst));
+    }
+    Expect(randomized.influentialStocks == exact.influentialStocks, "influential stocks differ");
+
+    return Finish("randomized PCA matches exact top " + std::to_string(TopN));
+}
@@ -0,0 +1,115 @@
+// Bollinger Bands and volatility slide a RollingStats window instead of
+// rescanning it; they must agree with a two-pass (long double) standard
+// deviation of every window. The series has spikes followed by nearly
+// flat stretches, so the variance collapses after each spike leaves the
+// window and the RollingStats::NeedsRebuild path is taken.
+#include "DataProcessor.h"
+#include "RollingStats.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace TestUtil;
+
+static const int Window = 20;
+
+struct WindowStats {
+    long double mean;
+    long double stdDev;  // population
+};
+
+static WindowStats TwoPass(const double* values, size_t n) {
+    long double sum = 0.0L;
+    for (size_t i = 0; i < n; ++i) {
+        sum += values[i];
+    }
+    long double mean = sum / n;
+    long double squares = 0.0L;
+    for (size_t i = 0; i < n; ++i) {
+        long double d = values[i] - mean;
+        squares += d * d;
+    }
+    return {mean, std::sqrt(squares / n)};
+}
+
+static std::vector<double> MakeCloses() {
+    std::mt19937_64 rng(23);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<double> closes;
+    double price = 100.0;
+    for (int segment = 0; segment < 40; ++segment) {
+        // An ordinary stretch, a spike, then a nearly flat stretch
+        for (int i = 0; i < 60; ++i) {
+            price = std::max(1.0, price + 0.5 * noise(rng));
+            closes.push_back(price);
+        }
+        closes.push_back(price * (segment % 2 == 0 ? 50.0 : 0.02));
+        for (int i = 0; i < 60; ++i) {
+            closes.push_back(price + 1e-6 * noise(rng));
+        }
+    }
+    return closes;
+}
+
+int main() {
+    std::vector<double> closes = MakeCloses();
+    PriceSeries series;
+    for (size_t i = 0; i < closes.size(); ++i) {
+        StockData bar{};
+        bar.date = static_cast<int32_t>(i);
+        bar.close = closes[i];
+        series.push_back(bar);
+    }
+    std::vector<double> returns;
+    for (size_t i = 0; i + 1 < closes.size(); ++i) {
+        returns.push_back((closes[i + 1] - closes[i]) / closes[i]);
+    }
+
+    // The data must actually drive the sliding window into a rebuild
+    size_t rebuilds = 0;
+    RollingStats stats;
+    stats.Rebuild(closes.data(), Window);
+    for (size_t i = Window; i < closes.size(); ++i) {
+        stats.Slide(closes[i], closes[i - Window]);
+        if (stats.NeedsRebuild()) {
+            ++rebuilds;
+            stats.Rebuild(closes.data() + i + 1 - Window, Window);
+        }
+    }
+    Expect(rebuilds >= 40, "only " + std::to_string(rebuilds) + " rebuilds triggered");
+
+    DataProcessor processor;
+    auto bands = processor.CalculateBollingerBands(series, Window, 2.0);
+    size_t expectedBands = closes.size() - Window + 1;
+    Expect(bands.upper.size() == expectedBands && bands.middle.size() == expectedBands &&
+               bands.lower.size() == expectedBands,
+           "Bollinger length");
+    for (size_t k = 0; k < bands.middle.size() && k < expectedBands; ++k) {
+        WindowStats reference = TwoPass(closes.data() + k, Window);
+        // Rounding of the mean itself, plus ~1e-9 of the deviation
+        long double allowed = 1e-14L * std::fabs(reference.mean) + 1e-9L * reference.stdDev;
+        double error = static_cast<double>(std::max(
+            {std::fabs(bands.middle[k] - reference.mean),
+             std::fabs(bands.upper[k] - (reference.mean + 2 * reference.stdDev)),
+             std::fabs(bands.lower[k] - (reference.mean - 2 * reference.stdDev))}));
+        if (error > allowed) {
+            Expect(false, "Bollinger window " + std::to_string(k) + " off by " + Format(error));
+        }
+    }
+
+    auto volatility = processor.CalculateVolatility(series, Window);
+    size_t expectedVolatility = returns.size() - Window + 1;
+    Expect(volatility.size() == expectedVolatility, "volatility length");
+    for (size_t k = 0; k < volatility.size() && k < expectedVolatility; ++k) {
+        long double reference = TwoPass(returns.data() + k, Window).stdDev * std::sqrt(252.0L);
+        double error = static_cast<double>(std::fabs(volatility[k] - reference));
+        if (error > 1e-9L * reference + 1e-15L) {
+            Expect(false, "volatility window " + std::to_string(k) + " off by " + Format(error));
+        }
+    }
+
+    return Finish("rolling deviations match two-pass (" + std::to_string(rebuilds) + " rebuilds)");
+}
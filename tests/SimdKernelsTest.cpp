@@ -0,0 +1,86 @@
+// With SetDeterministic(true) every SimdKernels implementation must give
+// the scalar result bit for bit, including the leftover elements after the
+// sixteen interleaved sums. Implementations this CPU lacks are skipped.
+#include "SimdKernels.h"
+#include "TestUtil.h"
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace TestUtil;
+
+struct Results {
+    std::vector<double> sums;
+    std::vector<double> squared;
+    std::vector<double> cross;
+    std::vector<std::vector<double>> returns;
+};
+
+static const size_t Lengths[] = {0, 1, 2, 3, 7, 15, 17, 31, 33, 63, 100, 257, 1001};
+
+static Results Run(const std::vector<double>& x, const std::vector<double>& y) {
+    Results results;
+    for (size_t n : Lengths) {
+        double meanX = n > 0 ? SimdKernels::Sum(x.data(), n) / n : 0.0;
+        double meanY = n > 0 ? SimdKernels::Sum(y.data(), n) / n : 0.0;
+        results.sums.push_back(SimdKernels::Sum(x.data(), n));
+        results.squared.push_back(SimdKernels::SumSquaredDeviations(x.data(), n, meanX));
+        results.cross.push_back(SimdKernels::SumCrossDeviations(x.data(), y.data(), n, meanX, meanY));
+        std::vector<double> returns(n > 1 ? n - 1 : 0);
+        SimdKernels::Returns(x.data(), n, returns.data());
+        results.returns.push_back(returns);
+    }
+    return results;
+}
+
+static void Compare(const Results& expected, const Results& actual, const std::string& name) {
+    for (size_t i = 0; i < sizeof(Lengths) / sizeof(Lengths[0]); ++i) {
+        std::string label = name + " n=" + std::to_string(Lengths[i]);
+        Expect(SameBits(expected.sums[i], actual.sums[i]), label + " Sum");
+        Expect(SameBits(expected.squared[i], actual.squared[i]), label + " SumSquaredDeviations");
+        Expect(SameBits(expected.cross[i], actual.cross[i]), label + " SumCrossDeviations");
+        bool same = expected.returns[i].size() == actual.returns[i].size();
+        for (size_t k = 0; same && k < expected.returns[i].size(); ++k) {
+            same = SameBits(expected.returns[i][k], actual.returns[i][k]);
+        }
+        Expect(same, label + " Returns");
+    }
+}
+
+int main() {
+    std::mt19937_64 rng(18);
+    std::normal_distribution<double> logReturn(0.0, 0.02);
+    std::vector<double> x;
+    std::vector<double> y;
+    double priceX = 100.0;
+    double priceY = 35.0;
+    for (size_t i = 0; i < 1001; ++i) {
+        priceX *= std::exp(logReturn(rng));
+        priceY *= std::exp(0.5 * logReturn(rng));
+        x.push_back(priceX);
+        y.push_back(priceY);
+    }
+
+    std::string original = SimdKernels::ActiveImplementation();
+    bool wasDeterministic = SimdKernels::Deterministic();
+    SimdKernels::SetDeterministic(true);
+
+    Expect(SimdKernels::UseImplementation("scalar"), "scalar implementation unavailable");
+    Results scalar = Run(x, y);
+    std::string checked = "scalar";
+    for (const char* name : {"sse2", "avx2", "avx512"}) {
+        if (!SimdKernels::UseImplementation(name)) {
+            std::cout << name << " not supported, skipped\n";
+            continue;
+        }
+        Compare(scalar, Run(x, y), name);
+        checked += std::string(", ") + name;
+    }
+
+    SimdKernels::SetDeterministic(wasDeterministic);
+    SimdKernels::UseImplementation(original.c_str());
+
+    return Finish("SimdKernels agree bit for bit (" + checked + ")");
+}
@@ -0,0 +1,114 @@
+// Streaming indicators must match the last value of the DataProcessor batch
+// functions bit for bit, through seeding, appends and revisions of the
+// newest bar.
+#include "DataProcessor.h"
+#include "StreamingIndicators.h"
+#include "TestUtil.h"
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace TestUtil;
+
+static std::string After(const char* what, size_t bars) {
+    return std::string(what) + " after " + std::to_string(bars) + " bars";
+}
+
+static PriceSeries SeriesOf(const std::vector<double>& closes) {
+    PriceSeries series;
+    for (double close : closes) {
+        StockData bar{};
+        bar.close = close;
+        series.push_back(bar);
+    }
+    return series;
+}
+
+int main() {
+    std::mt19937_64 rng(5);
+    std::normal_distribution<double> logReturn(0.0, 0.02);
+    std::uniform_int_distribution<int> reviseOneIn(0, 3);
+    DataProcessor processor;
+
+    // History lengths on both sides of every warm-up period
+    for (size_t seedLength = 0; seedLength <= 140; seedLength += 7) {
+        std::vector<double> closes;
+        double price = 100.0;
+        for (size_t i = 0; i < seedLength; ++i) {
+            price *= std::exp(logReturn(rng));
+            closes.push_back(price);
+        }
+
+        StreamingSMA sma(20);
+        StreamingEMA ema(20);
+        StreamingRSI rsi(14);
+        StreamingMACD macd;
+        StreamingBollinger bollinger(20, 2.0);
+        StreamingVolatility volatility(20);
+        PriceSeries history = SeriesOf(closes);
+        sma.Seed(history);
+        ema.Seed(history);
+        rsi.Seed(history);
+        macd.Seed(history);
+        bollinger.Seed(history);
+        volatility.Seed(history);
+
+        for (int step = 0; step < 150; ++step) {
+            double close = price * std::exp(logReturn(rng));
+            if (!closes.empty() && reviseOneIn(rng) == 0) {
+                closes.back() = close;
+                sma.Revise(close);
+                ema.Revise(close);
+                rsi.Revise(close);
+                macd.Revise(close);
+                bollinger.Revise(close);
+                volatility.Revise(close);
+            } else {
+                closes.push_back(close);
+                price = close;
+                sma.Update(close);
+                ema.Update(close);
+                rsi.Update(close);
+                macd.Update(close);
+                bollinger.Update(close);
+                volatility.Update(close);
+            }
+
+            PriceSeries series = SeriesOf(closes);
+            size_t bars = closes.size();
+            auto smaBatch = processor.CalculateSMA(series, 20);
+            auto emaBatch = processor.CalculateEMA(series, 20);
+            auto rsiBatch = processor.CalculateRSI(series, 14);
+            auto macdBatch = processor.CalculateMACD(series);
+            auto bands = processor.CalculateBollingerBands(series, 20, 2.0);
+            auto volBatch = processor.CalculateVolatility(series, 20);
+
+            Expect(sma.Ready() == !smaBatch.empty() &&
+                       (!sma.Ready() || SameBits(sma.Value(), smaBatch.back())),
+                   After("SMA", bars));
+            Expect(ema.Ready() == !emaBatch.empty() &&
+                       (!ema.Ready() || SameBits(ema.Value(), emaBatch.back())),
+                   After("EMA", bars));
+            Expect(rsi.Ready() == !rsiBatch.empty() &&
+                       (!rsi.Ready() || SameBits(rsi.Value(), rsiBatch.back())),
+                   After("RSI", bars));
+            Expect(macd.Ready() == !macdBatch.macd.empty() &&
+                       (!macd.Ready() || (SameBits(macd.MACD(), macdBatch.macd.back()) &&
+                                          SameBits(macd.Signal(), macdBatch.signal.back()) &&
+                                          SameBits(macd.Histogram(), macdBatch.histogram.back()))),
+                   After("MACD", bars));
+            Expect(bollinger.Ready() == !bands.middle.empty() &&
+                       (!bollinger.Ready() || (SameBits(bollinger.Middle(), bands.middle.back()) &&
+                                               SameBits(bollinger.Upper(), bands.upper.back()) &&
+                                               SameBits(bollinger.Lower(), bands.lower.back()))),
+                   After("Bollinger", bars));
+            Expect(volatility.Ready() == !volBatch.empty() &&
+                       (!volatility.Ready() || SameBits(volatility.Value(), volBatch.back())),
+                   After("volatility", bars));
+        }
+    }
+
+    return Finish("streaming indicators match batch");
+}
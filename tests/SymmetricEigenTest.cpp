@@ -0,0 +1,133 @@
+// SymmetricEigen must return a true decomposition: A v = lambda v for every
+// pair, orthonormal vectors, eigenvalues sorted and summing to the trace,
+// and the documented sign convention.
+#include "SymmetricEigen.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using Matrix = std::vector<std::vector<double>>;
+
+using namespace TestUtil;
+
+// Sample covariance of a one-factor model, the shape PCA sees in practice
+static Matrix FactorCovariance(size_t n, std::mt19937_64& rng) {
+    std::normal_distribution<double> normal;
+    size_t m = n + 50;
+    Matrix samples(m, std::vector<double>(n));
+    for (auto& row : samples) {
+        double factor = normal(rng);
+        for (size_t j = 0; j < n; ++j) {
+            row[j] = factor * (1.0 + 0.01 * static_cast<double>(j)) + 0.3 * normal(rng);
+        }
+    }
+    Matrix covariance(n, std::vector<double>(n));
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            double sum = 0.0;
+            for (const auto& row : samples) {
+                sum += row[i] * row[j];
+            }
+            covariance[i][j] = covariance[j][i] = sum / static_cast<double>(m);
+        }
+    }
+    return covariance;
+}
+
+static void CheckDecomposition(const Matrix& matrix, const std::string& label) {
+    size_t n = matrix.size();
+    SymmetricEigenResult result = SymmetricEigen(matrix);
+    if (!result.success || result.values.size() != n || result.vectors.size() != n) {
+        Expect(false, label + ": no decomposition");
+        return;
+    }
+
+    double scale = 0.0;
+    double trace = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        trace += matrix[i][i];
+        for (double value : matrix[i]) {
+            scale = std::max(scale, std::fabs(value));
+        }
+    }
+    double tolerance = 1e-10 * std::max(1.0, scale) * static_cast<double>(n);
+
+    double residual = 0.0;
+    double orthogonality = 0.0;
+    double valueSum = 0.0;
+    bool sorted = true;
+    bool signs = true;
+    for (size_t k = 0; k < n; ++k) {
+        const std::vector<double>& v = result.vectors[k];
+        for (size_t i = 0; i < n; ++i) {
+            double product = 0.0;
+            for (size_t j = 0; j < n; ++j) {
+                product += matrix[i][j] * v[j];
+            }
+            residual = std::max(residual, std::fabs(product - result.values[k] * v[i]));
+        }
+        for (size_t l = 0; l < n; ++l) {
+            double dot = 0.0;
+            for (size_t j = 0; j < n; ++j) {
+                dot += v[j] * result.vectors[l][j];
+            }
+            orthogonality = std::max(orthogonality, std::fabs(dot - (k == l ? 1.0 : 0.0)));
+        }
+        auto largest = std::max_element(v.begin(), v.end(), [](double a, double b) {
+            return std::fabs(a) < std::fabs(b);
+        });
+        signs = signs && *largest > 0.0;
+        sorted = sorted && (k == 0 || result.values[k] <= result.values[k - 1]);
+        valueSum += result.values[k];
+    }
+
+    Expect(residual <= tolerance, label + ": residual " + Format(residual));
+    Expect(orthogonality <= 1e-10 * static_cast<double>(n),
+           label + ": orthogonality " + Format(orthogonality));
+    Expect(std::fabs(valueSum - trace) <= tolerance, label + ": eigenvalues do not sum to the trace");
+    Expect(sorted, label + ": eigenvalues not largest first");
+    Expect(signs, label + ": largest entry of a vector is not positive");
+}
+
+int main() {
+    std::mt19937_64 rng(1);
+    for (size_t n : {1, 2, 3, 10, 60, 150}) {
+        CheckDecomposition(FactorCovariance(n, rng), "factor covariance n=" + std::to_string(n));
+    }
+
+    // Repeated eigenvalues and an indefinite matrix
+    CheckDecomposition(Matrix(8, std::vector<double>(8, 0.0)), "zero matrix");
+    Matrix identity(5, std::vector<double>(5, 0.0));
+    for (size_t i = 0; i < 5; ++i) {
+        identity[i][i] = 1.0;
+    }
+    CheckDecomposition(identity, "identity");
+    CheckDecomposition({{1, 2}, {2, 1}}, "[[1,2],[2,1]]");
+
+    SymmetricEigenResult small = SymmetricEigen({{1, 2}, {2, 1}});
+    Expect(small.success && std::fabs(small.values[0] - 3.0) < 1e-12 &&
+               std::fabs(small.values[1] + 1.0) < 1e-12,
+           "[[1,2],[2,1]] eigenvalues");
+
+    // Only the lower triangle is read
+    Matrix lower = FactorCovariance(6, rng);
+    Matrix garbled = lower;
+    for (size_t i = 0; i < 6; ++i) {
+        for (size_t j = i + 1; j < 6; ++j) {
+            garbled[i][j] = 1e6;
+        }
+    }
+    SymmetricEigenResult expected = SymmetricEigen(lower);
+    SymmetricEigenResult fromLower = SymmetricEigen(garbled);
+    Expect(fromLower.success && fromLower.values == expected.values &&
+               fromLower.vectors == expected.vectors,
+           "upper triangle ignored");
+
+    Expect(!SymmetricEigen({{1, 2, 3}, {4, 5, 6}}).success, "non-square input rejected");
+
+    return Finish("SymmetricEigen decompositions check out");
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Checks shared by the programs under tests/. A test records failures with
+// Expect and ends main with `return Finish("...")`, so ctest sees a nonzero
+// exit code when anything failed.
+namespace TestUtil {
+
+inline int& Failures() {
+    static int failures = 0;
+    return failures;
+}
+
+// Only the first few failures are printed; the count covers all of them
+inline void Expect(bool condition, const std::string& what) {
+    if (!condition && ++Failures() <= 10) {
+        std::cerr << "FAIL: " << what << "\n";
+    }
+}
+
+inline bool SameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+// Short form of a measured error for failure messages
+inline std::string Format(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3g", value);
+    return text;
+}
+
+// Reports the outcome; `passed` is printed when nothing failed
+inline int Finish(const std::string& passed) {
+    if (Failures() > 0) {
+        std::cerr << Failures() << " failures\n";
+        return 1;
+    }
+    std::cout << passed << "\n";
+    return 0;
+}
+
+} // namespace TestUtil